@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dist"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/dist.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
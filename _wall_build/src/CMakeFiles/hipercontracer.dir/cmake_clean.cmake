@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hipercontracer.dir/hipercontracer.cc.o"
+  "CMakeFiles/hipercontracer.dir/hipercontracer.cc.o.d"
+  "hipercontracer"
+  "hipercontracer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hipercontracer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hpctcollector.dir/hpctcollector.cc.o"
+  "CMakeFiles/hpctcollector.dir/hpctcollector.cc.o.d"
+  "hpctcollector"
+  "hpctcollector.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hpctcollector.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
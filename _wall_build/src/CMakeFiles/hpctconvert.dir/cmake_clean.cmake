@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hpctconvert.dir/hpctconvert.cc.o"
+  "CMakeFiles/hpctconvert.dir/hpctconvert.cc.o.d"
+  "hpctconvert"
+  "hpctconvert.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hpctconvert.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hpcttail.dir/hpcttail.cc.o"
+  "CMakeFiles/hpcttail.dir/hpcttail.cc.o.d"
+  "hpcttail"
+  "hpcttail.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hpcttail.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
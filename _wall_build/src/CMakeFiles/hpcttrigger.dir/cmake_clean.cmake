@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hpcttrigger.dir/hpcttrigger.cc.o"
+  "CMakeFiles/hpcttrigger.dir/hpcttrigger.cc.o.d"
+  "hpcttrigger"
+  "hpcttrigger.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hpcttrigger.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/libhipercontracer-shared.dir/appendlog.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/appendlog.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/binaryresults.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/binaryresults.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/burstping.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/burstping.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/destinationinfo.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/destinationinfo.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/destinationregistry.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/destinationregistry.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/logger.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/logger.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/parallelcompressor.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/parallelcompressor.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/ping.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/ping.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/probetable.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/probetable.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/resultentry.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/resultentry.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/resultsformatter.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/resultsformatter.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/resultsindex.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/resultsindex.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/resultstransport.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/resultstransport.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/resultswriter.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/resultswriter.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/rttsketch.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/rttsketch.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/service.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/service.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/tools.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/tools.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/traceroute.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/traceroute.cc.o.d"
+  "CMakeFiles/libhipercontracer-shared.dir/zstdcompressor.cc.o"
+  "CMakeFiles/libhipercontracer-shared.dir/zstdcompressor.cc.o.d"
+  "libhipercontracer.pdb"
+  "libhipercontracer.so"
+  "libhipercontracer.so.1"
+  "libhipercontracer.so.1.4.7"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libhipercontracer-shared.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
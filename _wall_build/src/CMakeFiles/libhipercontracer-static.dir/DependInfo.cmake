@@ -0,0 +1,37 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/appendlog.cc" "src/CMakeFiles/libhipercontracer-static.dir/appendlog.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/appendlog.cc.o.d"
+  "/root/repo/src/binaryresults.cc" "src/CMakeFiles/libhipercontracer-static.dir/binaryresults.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/binaryresults.cc.o.d"
+  "/root/repo/src/burstping.cc" "src/CMakeFiles/libhipercontracer-static.dir/burstping.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/burstping.cc.o.d"
+  "/root/repo/src/destinationinfo.cc" "src/CMakeFiles/libhipercontracer-static.dir/destinationinfo.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/destinationinfo.cc.o.d"
+  "/root/repo/src/destinationregistry.cc" "src/CMakeFiles/libhipercontracer-static.dir/destinationregistry.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/destinationregistry.cc.o.d"
+  "/root/repo/src/logger.cc" "src/CMakeFiles/libhipercontracer-static.dir/logger.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/logger.cc.o.d"
+  "/root/repo/src/parallelcompressor.cc" "src/CMakeFiles/libhipercontracer-static.dir/parallelcompressor.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/parallelcompressor.cc.o.d"
+  "/root/repo/src/ping.cc" "src/CMakeFiles/libhipercontracer-static.dir/ping.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/ping.cc.o.d"
+  "/root/repo/src/probetable.cc" "src/CMakeFiles/libhipercontracer-static.dir/probetable.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/probetable.cc.o.d"
+  "/root/repo/src/resultentry.cc" "src/CMakeFiles/libhipercontracer-static.dir/resultentry.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/resultentry.cc.o.d"
+  "/root/repo/src/resultsformatter.cc" "src/CMakeFiles/libhipercontracer-static.dir/resultsformatter.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/resultsformatter.cc.o.d"
+  "/root/repo/src/resultsindex.cc" "src/CMakeFiles/libhipercontracer-static.dir/resultsindex.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/resultsindex.cc.o.d"
+  "/root/repo/src/resultstransport.cc" "src/CMakeFiles/libhipercontracer-static.dir/resultstransport.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/resultstransport.cc.o.d"
+  "/root/repo/src/resultswriter.cc" "src/CMakeFiles/libhipercontracer-static.dir/resultswriter.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/resultswriter.cc.o.d"
+  "/root/repo/src/rttsketch.cc" "src/CMakeFiles/libhipercontracer-static.dir/rttsketch.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/rttsketch.cc.o.d"
+  "/root/repo/src/service.cc" "src/CMakeFiles/libhipercontracer-static.dir/service.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/service.cc.o.d"
+  "/root/repo/src/tools.cc" "src/CMakeFiles/libhipercontracer-static.dir/tools.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/tools.cc.o.d"
+  "/root/repo/src/traceroute.cc" "src/CMakeFiles/libhipercontracer-static.dir/traceroute.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/traceroute.cc.o.d"
+  "/root/repo/src/zstdcompressor.cc" "src/CMakeFiles/libhipercontracer-static.dir/zstdcompressor.cc.o" "gcc" "src/CMakeFiles/libhipercontracer-static.dir/zstdcompressor.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
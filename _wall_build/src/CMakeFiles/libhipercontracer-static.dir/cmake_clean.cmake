@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/libhipercontracer-static.dir/appendlog.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/appendlog.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/binaryresults.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/binaryresults.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/burstping.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/burstping.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/destinationinfo.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/destinationinfo.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/destinationregistry.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/destinationregistry.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/logger.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/logger.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/parallelcompressor.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/parallelcompressor.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/ping.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/ping.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/probetable.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/probetable.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/resultentry.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/resultentry.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/resultsformatter.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/resultsformatter.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/resultsindex.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/resultsindex.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/resultstransport.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/resultstransport.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/resultswriter.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/resultswriter.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/rttsketch.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/rttsketch.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/service.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/service.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/tools.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/tools.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/traceroute.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/traceroute.cc.o.d"
+  "CMakeFiles/libhipercontracer-static.dir/zstdcompressor.cc.o"
+  "CMakeFiles/libhipercontracer-static.dir/zstdcompressor.cc.o.d"
+  "libhipercontracer.a"
+  "libhipercontracer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libhipercontracer-static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/resultsformatbenchmark.dir/resultsformatbenchmark.cc.o"
+  "CMakeFiles/resultsformatbenchmark.dir/resultsformatbenchmark.cc.o.d"
+  "resultsformatbenchmark"
+  "resultsformatbenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/resultsformatbenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
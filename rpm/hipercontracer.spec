@@ -12,6 +12,7 @@ BuildRequires: cmake
 BuildRequires: gcc
 BuildRequires: gcc-c++
 BuildRequires: boost-devel
+BuildRequires: libzstd-devel
 BuildRoot: %{_tmppath}/%{name}-%{version}-build
 Requires: %{name}-libhipercontracer = %{version}-%{release}
 Recommends: python3-psycopg2
@@ -32,7 +33,7 @@ High-Performance Connectivity Tracer (HiPerConTracer) is a ping/traceroute servi
 
 %build
 # NOTE: CMAKE_VERBOSE_MAKEFILE=OFF for reduced log output!
-%cmake -DCMAKE_INSTALL_PREFIX=/usr -DCMAKE_VERBOSE_MAKEFILE=OFF .
+%cmake -DCMAKE_INSTALL_PREFIX=/usr -DCMAKE_VERBOSE_MAKEFILE=OFF -DWITH_ZSTD=ON .
 make %{?_smp_mflags}
 
 %pre
@@ -46,10 +47,20 @@ make install DESTDIR=%{buildroot}
 %{_bindir}/addressinfogenerator
 %{_bindir}/get-default-ips
 %{_bindir}/hipercontracer
+%{_bindir}/hpctcollector
+%{_bindir}/hpctconvert
+%{_bindir}/hpctindexquery
+%{_bindir}/hpcttail
+%{_bindir}/hpcttraindictionary
 %{_bindir}/tracedataimporter
 %{_mandir}/man1/addressinfogenerator.1.gz
 %{_mandir}/man1/get-default-ips.1.gz
 %{_mandir}/man1/hipercontracer.1.gz
+%{_mandir}/man1/hpctcollector.1.gz
+%{_mandir}/man1/hpctconvert.1.gz
+%{_mandir}/man1/hpctindexquery.1.gz
+%{_mandir}/man1/hpcttail.1.gz
+%{_mandir}/man1/hpcttraindictionary.1.gz
 %{_mandir}/man1/tracedataimporter.1.gz
 %{_datadir}/doc/hipercontracer/examples/hipercontracer-database-configuration
 %{_datadir}/doc/hipercontracer/examples/SQL/README
@@ -89,6 +100,7 @@ Summary: HiPerConTracer library development files
 Group: Development/Libraries
 Requires: %{name}-libhipercontracer = %{version}-%{release}
 Requires: boost-devel
+Requires: libzstd-devel
 
 %description libhipercontracer-devel
 High-Performance Connectivity Tracer (HiPerConTracer) is a
@@ -99,14 +111,26 @@ to integrate HiPerConTracer into own programs.
 
 
 %files libhipercontracer-devel
+%{_includedir}/hipercontracer/appendlog.h
+%{_includedir}/hipercontracer/binaryresults.h
+%{_includedir}/hipercontracer/burstping.h
 %{_includedir}/hipercontracer/destinationinfo.h
+%{_includedir}/hipercontracer/destinationregistry.h
 %{_includedir}/hipercontracer/logger.h
+%{_includedir}/hipercontracer/parallelcompressor.h
 %{_includedir}/hipercontracer/ping.h
+%{_includedir}/hipercontracer/probetable.h
 %{_includedir}/hipercontracer/resultentry.h
+%{_includedir}/hipercontracer/resultsformatter.h
+%{_includedir}/hipercontracer/resultsindex.h
+%{_includedir}/hipercontracer/resultsrecord.h
+%{_includedir}/hipercontracer/resultstransport.h
 %{_includedir}/hipercontracer/resultswriter.h
+%{_includedir}/hipercontracer/rttsketch.h
 %{_includedir}/hipercontracer/service.h
 %{_includedir}/hipercontracer/tools.h
 %{_includedir}/hipercontracer/traceroute.h
+%{_includedir}/hipercontracer/zstdcompressor.h
 %{_libdir}/libhipercontracer*.so
 %{_libdir}/libhipercontracer.a
 
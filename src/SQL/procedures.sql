@@ -35,6 +35,8 @@
 
 -- ###### Median calculation ################################################
 -- From: https://wiki.postgresql.org/wiki/Aggregate_Median
+-- NOTE: This aggregate sorts all values. For RTT statistics over longer time
+--       ranges, use table PingRollup instead (see schema.sql).
 DROP FUNCTION IF EXISTS _final_median(NUMERIC[]) CASCADE;
 CREATE FUNCTION _final_median(NUMERIC[])
    RETURNS NUMERIC AS
@@ -67,6 +67,77 @@ CREATE TABLE ProviderInfo (
 );
 
 
+-- ###### Partitions ########################################################
+-- The results tables are partitioned by time stamp, into daily or weekly
+-- partitions. The importer creates the partitions ahead of time, by
+-- createPartitions(). Old partitions are detached by detachPartitions(), and
+-- remain as separate tables (which may be archived and dropped).
+-- Both functions run with the privileges of their owner, since the importer
+-- is not allowed to change the tables.
+DROP FUNCTION IF EXISTS createPartitions(TEXT, TEXT, TIMESTAMP WITHOUT TIME ZONE, TIMESTAMP WITHOUT TIME ZONE);
+CREATE FUNCTION createPartitions(tableName TEXT,
+                                 unit      TEXT,
+                                 fromTime  TIMESTAMP WITHOUT TIME ZONE,
+                                 toTime    TIMESTAMP WITHOUT TIME ZONE)
+   RETURNS INTEGER AS
+$$
+DECLARE
+   partitionStart TIMESTAMP WITHOUT TIME ZONE;
+   partitionEnd   TIMESTAMP WITHOUT TIME ZONE;
+   partitionName  TEXT;
+   created        INTEGER := 0;
+BEGIN
+   IF unit NOT IN ('day', 'week') THEN
+      RAISE EXCEPTION 'Unsupported partition unit %', unit;
+   END IF;
+   partitionStart := date_trunc(unit, fromTime);
+   WHILE partitionStart <= toTime LOOP
+      partitionEnd  := partitionStart + ('1 ' || unit)::INTERVAL;
+      partitionName := lower(tableName) || '_p' || to_char(partitionStart, 'YYYYMMDD');
+      IF to_regclass(partitionName) IS NULL THEN
+         BEGIN
+            EXECUTE format('CREATE TABLE %I PARTITION OF %I FOR VALUES FROM (%L) TO (%L)',
+                           partitionName, lower(tableName), partitionStart, partitionEnd);
+            created := created + 1;
+         EXCEPTION WHEN duplicate_table THEN
+            NULL;   -- Created by another importer meanwhile
+         END;
+      END IF;
+      partitionStart := partitionEnd;
+   END LOOP;
+   RETURN created;
+END;
+$$
+LANGUAGE plpgsql SECURITY DEFINER SET search_path = public;
+REVOKE ALL ON FUNCTION createPartitions(TEXT, TEXT, TIMESTAMP WITHOUT TIME ZONE, TIMESTAMP WITHOUT TIME ZONE) FROM PUBLIC;
+
+DROP FUNCTION IF EXISTS detachPartitions(TEXT, TIMESTAMP WITHOUT TIME ZONE);
+CREATE FUNCTION detachPartitions(tableName TEXT,
+                                 olderThan TIMESTAMP WITHOUT TIME ZONE)
+   RETURNS SETOF TEXT AS
+$$
+DECLARE
+   entry RECORD;
+BEGIN
+   FOR entry IN
+      SELECT C.relname AS Name,
+             substring(pg_get_expr(C.relpartbound, C.oid) FROM 'TO \(''([^'']+)''\)')::TIMESTAMP AS UpperBound
+      FROM pg_inherits I
+      INNER JOIN pg_class C ON (C.oid = I.inhrelid)
+      WHERE I.inhparent = lower(tableName)::REGCLASS
+      ORDER BY C.relname
+   LOOP
+      IF entry.UpperBound <= olderThan THEN
+         EXECUTE format('ALTER TABLE %I DETACH PARTITION %I', lower(tableName), entry.Name);
+         RETURN NEXT entry.Name;
+      END IF;
+   END LOOP;
+END;
+$$
+LANGUAGE plpgsql SECURITY DEFINER SET search_path = public;
+REVOKE ALL ON FUNCTION detachPartitions(TEXT, TIMESTAMP WITHOUT TIME ZONE) FROM PUBLIC;
+
+
 -- ###### Ping ##############################################################
 DROP TABLE IF EXISTS Ping;
 CREATE TABLE Ping (
@@ -77,16 +148,121 @@ CREATE TABLE Ping (
    Status    SMALLINT NOT NULL,                      -- Status
    RTT       INTEGER  NOT NULL,                      -- microseconds (max. 2147s)
    PRIMARY KEY (FromIP, ToIP, TC, TimeStamp)
-);
+) PARTITION BY RANGE (TimeStamp);
 
-CREATE INDEX PingTimeStampIndex ON Ping (TimeStamp ASC);
+CREATE INDEX PingTimeStampIndex ON Ping USING BRIN (TimeStamp);
 -- CREATE INDEX PingFromIPIndex ON Ping (FromIP ASC);
 -- CREATE INDEX PingToIPIndex ON Ping (ToIP ASC);
 -- CREATE INDEX PingStatusIndex ON Ping (Status ASC);
 
 
+-- ###### Ping rollups ######################################################
+-- Statistics per source, destination, traffic class and time bucket, which
+-- the importer maintains with setting rollup_interval (bucket length in
+-- seconds). The RTT values are those of the successful pings (Status 255).
+-- Ping summaries of HiPerConTracer (--pingsummary) are added as well, with
+-- the same sketch buckets (see RTTSketch in rttsketch.h).
+-- The statistics of coarser buckets are given by merging finer ones:
+--
+-- SELECT date_trunc('hour', Bucket) AS Hour, SUM(Probes), SUM(Lost),
+--        MIN(MinRTT), MAX(MaxRTT), SUM(SumRTT) / NULLIF(SUM(Probes - Lost), 0),
+--        rttSketchQuantile(mergeRTTSketch(RTTSketch), 0.5) AS MedianRTT,
+--        rttSketchQuantile(mergeRTTSketch(RTTSketch), 0.95) AS P95RTT
+-- FROM PingRollup
+-- WHERE FromIP = '10.1.1.1' AND ToIP = '10.2.2.2' AND TC = 0 AND
+--       Bucket >= '2026-10-01' AND Bucket < '2026-11-01'
+-- GROUP BY 1 ORDER BY 1;
+--
+-- RTT sketch: histogram with logarithmic buckets, each split into 16 linear
+-- sub-buckets. RTTs below 32 us are counted exactly, larger ones with a
+-- relative error of at most 1/32. For RTT value v (in us) with highest bit
+-- e >= 4, the sketch bucket is (e - 3) * 16 + ((v >> (e - 4)) & 15), i.e.
+-- there are at most 448 buckets. A sketch is an array of the non-empty
+-- buckets, sorted by bucket, with each entry being (bucket << 32) | count.
+
+-- ------ Sketch bucket of an RTT value -------------------------------------
+DROP FUNCTION IF EXISTS rttSketchBucket(INTEGER) CASCADE;
+CREATE FUNCTION rttSketchBucket(INTEGER)
+   RETURNS INTEGER AS
+$$
+   SELECT CASE
+      WHEN $1 < 16 THEN GREATEST($1, 0)
+      ELSE (Exponent - 3) * 16 + (($1 >> (Exponent - 4)) & 15)
+   END
+   FROM (SELECT length(ltrim(GREATEST($1, 0)::BIT(32)::TEXT, '0')) - 1 AS Exponent) sub;
+$$
+LANGUAGE 'sql' IMMUTABLE;
+
+-- ------ RTT value represented by a sketch bucket (centre of its range) ---
+DROP FUNCTION IF EXISTS rttSketchValue(INTEGER) CASCADE;
+CREATE FUNCTION rttSketchValue(INTEGER)
+   RETURNS INTEGER AS
+$$
+   SELECT CASE
+      WHEN $1 < 16 THEN $1
+      ELSE ((16 + ($1 & 15)) << ($1 / 16 - 1)) + ((1 << ($1 / 16 - 1)) >> 1)
+   END;
+$$
+LANGUAGE 'sql' IMMUTABLE;
+
+-- ------ Merge sketches ----------------------------------------------------
+DROP FUNCTION IF EXISTS _merge_rttsketch(BIGINT[], BIGINT[]) CASCADE;
+CREATE FUNCTION _merge_rttsketch(BIGINT[], BIGINT[])
+   RETURNS BIGINT[] AS
+$$
+   SELECT COALESCE(array_agg((Bucket << 32) | LEAST(Count, 4294967295) ORDER BY Bucket), '{}')
+   FROM (
+     SELECT E >> 32 AS Bucket, SUM(E & 4294967295)::BIGINT AS Count
+     FROM unnest($1 || $2) E
+     GROUP BY 1
+   ) sub;
+$$
+LANGUAGE 'sql' IMMUTABLE;
+
+DROP AGGREGATE IF EXISTS mergeRTTSketch(BIGINT[]);
+CREATE AGGREGATE mergeRTTSketch(BIGINT[]) (
+  SFUNC=_merge_rttsketch,
+  STYPE=BIGINT[],
+  INITCOND='{}'
+);
+
+-- ------ Quantile (0.0 to 1.0) of a sketch ---------------------------------
+DROP FUNCTION IF EXISTS rttSketchQuantile(BIGINT[], DOUBLE PRECISION) CASCADE;
+CREATE FUNCTION rttSketchQuantile(BIGINT[], DOUBLE PRECISION)
+   RETURNS INTEGER AS
+$$
+   SELECT rttSketchValue(Bucket)
+   FROM (
+     SELECT (E >> 32)::INTEGER AS Bucket,
+            SUM(E & 4294967295) OVER (ORDER BY E) AS Cumulative,
+            SUM(E & 4294967295) OVER ()           AS Total
+     FROM unnest($1) E
+   ) sub
+   WHERE Cumulative >= GREATEST(1, CEIL($2 * Total))
+   ORDER BY Bucket
+   LIMIT 1;
+$$
+LANGUAGE 'sql' IMMUTABLE;
+
+DROP TABLE IF EXISTS PingRollup;
+CREATE TABLE PingRollup (
+   Bucket    TIMESTAMP WITHOUT TIME ZONE NOT NULL,   -- Start of time bucket (always UTC!)
+   FromIP    INET     NOT NULL,                      -- Source IP address
+   ToIP      INET     NOT NULL,                      -- Destination IP address
+   TC        SMALLINT NOT NULL DEFAULT 0,            -- Traffic Class
+   Probes    INTEGER  NOT NULL,                      -- Number of pings
+   Lost      INTEGER  NOT NULL,                      -- Number of pings without success
+   MinRTT    INTEGER,                                -- microseconds (NULL: all lost)
+   MaxRTT    INTEGER,                                -- microseconds (NULL: all lost)
+   SumRTT    BIGINT   NOT NULL,                      -- Sum of RTTs
+   SumSqRTT  DOUBLE PRECISION NOT NULL,              -- Sum of squared RTTs
+   RTTSketch BIGINT[] NOT NULL,                      -- RTT sketch (see above)
+   PRIMARY KEY (FromIP, ToIP, TC, Bucket)
+);
+
+
 -- ###### Traceroute ########################################################
-DROP TABLE IF EXISTS Traceroute;
+DROP TABLE IF EXISTS Traceroute CASCADE;
 CREATE TABLE Traceroute (
    TimeStamp TIMESTAMP WITHOUT TIME ZONE NOT NULL,   -- Time stamp (always UTC!)
    FromIP    INET     NOT NULL,                      -- Source IP address
@@ -100,15 +276,105 @@ CREATE TABLE Traceroute (
    PathHash  BIGINT   NOT NULL,                      -- Hash over full path
    Round     INTEGER  NOT NULL DEFAULT 0,            -- Round number
    PRIMARY KEY (FromIP,ToIP,TC,TimeStamp,Round,HopNumber)
-);
+) PARTITION BY RANGE (TimeStamp);
 
-CREATE INDEX TracerouteTimeStampIndex ON Traceroute (TimeStamp ASC);
+CREATE INDEX TracerouteTimeStampIndex ON Traceroute USING BRIN (TimeStamp);
 -- CREATE INDEX TraceroutePathHashIndex ON Traceroute (PathHash ASC);
 -- CREATE INDEX TracerouteFromIPIndex ON Traceroute (FromIP ASC);
 -- CREATE INDEX TracerouteToIPIndex ON Traceroute (ToIP ASC);
 -- CREATE INDEX TracerouteHopIPIndex ON Traceroute (HopIP ASC);
 
 
+-- ###### Traceroute with normalized paths ##################################
+-- Alternative to table Traceroute, used by the importer with setting
+-- traceroute_schema = Normalized: each path is stored only once, in table
+-- Path. A traceroute run refers to its path by the path hash, and stores the
+-- status and RTT values of its hops as arrays (index 1 is hop 1).
+DROP TABLE IF EXISTS Path CASCADE;
+CREATE TABLE Path (
+   PathHash  BIGINT   NOT NULL,                      -- Hash over full path
+   TotalHops SMALLINT NOT NULL,                      -- Total number of hops
+   HopIP     INET[]   NOT NULL,                      -- Router or Destination IP address, per hop
+   PRIMARY KEY (PathHash)
+);
+
+DROP TABLE IF EXISTS TracerouteRun CASCADE;
+CREATE TABLE TracerouteRun (
+   TimeStamp   TIMESTAMP WITHOUT TIME ZONE NOT NULL, -- Time stamp (always UTC!)
+   FromIP      INET       NOT NULL,                  -- Source IP address
+   ToIP        INET       NOT NULL,                  -- Destination IP address
+   TC          SMALLINT   NOT NULL DEFAULT 0,        -- Traffic Class
+   Round       INTEGER    NOT NULL DEFAULT 0,        -- Round number
+   StatusFlags SMALLINT   NOT NULL,                  -- Status flags of the run
+   PathHash    BIGINT     NOT NULL REFERENCES Path(PathHash),
+   Status      SMALLINT[] NOT NULL,                  -- Status, per hop
+   RTT         INTEGER[]  NOT NULL,                  -- microseconds (max. 2147s), per hop
+   PRIMARY KEY (FromIP,ToIP,TC,TimeStamp,Round)
+) PARTITION BY RANGE (TimeStamp);
+
+CREATE INDEX TracerouteRunTimeStampIndex ON TracerouteRun USING BRIN (TimeStamp);
+-- CREATE INDEX TracerouteRunPathHashIndex ON TracerouteRun (PathHash ASC);
+
+-- ------ Compatibility views, with one row per hop like table Traceroute ---
+CREATE VIEW TracerouteHops AS
+   SELECT R.TimeStamp, R.FromIP, R.ToIP, R.TC,
+          Hop.Number::SMALLINT                   AS HopNumber,
+          P.TotalHops,
+          (R.Status[Hop.Number] | R.StatusFlags) AS Status,
+          R.RTT[Hop.Number]                      AS RTT,
+          P.HopIP[Hop.Number]                    AS HopIP,
+          R.PathHash,
+          R.Round
+   FROM TracerouteRun R
+   INNER JOIN Path P ON (P.PathHash = R.PathHash)
+   CROSS JOIN LATERAL generate_subscripts(R.RTT, 1) AS Hop(Number);
+
+-- All traceroute results, e.g. while migrating from table Traceroute:
+CREATE VIEW TracerouteAll AS
+   SELECT * FROM Traceroute
+   UNION ALL
+   SELECT * FROM TracerouteHops;
+
+
+-- ###### Latest results ####################################################
+-- The latest ping and traceroute results per source, destination and
+-- traffic class, which the importer maintains with setting
+-- latest_results = yes. A row is only replaced by newer results.
+DROP TABLE IF EXISTS LatestPing;
+CREATE TABLE LatestPing (
+   FromIP    INET     NOT NULL,                      -- Source IP address
+   ToIP      INET     NOT NULL,                      -- Destination IP address
+   TC        SMALLINT NOT NULL DEFAULT 0,            -- Traffic Class
+   TimeStamp TIMESTAMP WITHOUT TIME ZONE NOT NULL,   -- Time stamp of latest ping (always UTC!)
+   Status    SMALLINT NOT NULL,                      -- Status of latest ping
+   RTT       INTEGER  NOT NULL,                      -- microseconds, of latest ping
+
+   -- ------ Pings in the results file of the latest ping -------------------
+   Probes    INTEGER  NOT NULL,                      -- Number of pings
+   Lost      INTEGER  NOT NULL,                      -- Number of pings without success
+   MinRTT    INTEGER,                                -- microseconds (NULL: all lost)
+   MaxRTT    INTEGER,                                -- microseconds (NULL: all lost)
+   MeanRTT   INTEGER,                                -- microseconds (NULL: all lost)
+   PRIMARY KEY (FromIP, ToIP, TC)
+);
+
+DROP TABLE IF EXISTS LatestPath;
+CREATE TABLE LatestPath (
+   FromIP      INET       NOT NULL,                  -- Source IP address
+   ToIP        INET       NOT NULL,                  -- Destination IP address
+   TC          SMALLINT   NOT NULL DEFAULT 0,        -- Traffic Class
+   TimeStamp   TIMESTAMP WITHOUT TIME ZONE NOT NULL, -- Time stamp of latest run (always UTC!)
+   Round       INTEGER    NOT NULL DEFAULT 0,        -- Round number
+   TotalHops   SMALLINT   NOT NULL,                  -- Total number of hops
+   StatusFlags SMALLINT   NOT NULL,                  -- Status flags of the run
+   PathHash    BIGINT     NOT NULL,                  -- Hash over full path
+   HopIP       INET[]     NOT NULL,                  -- Router or Destination IP address, per hop
+   Status      SMALLINT[] NOT NULL,                  -- Status, per hop
+   RTT         INTEGER[]  NOT NULL,                  -- microseconds (max. 2147s), per hop
+   PRIMARY KEY (FromIP, ToIP, TC)
+);
+
+
 -- ###### Address Information ###############################################
 DROP TABLE IF EXISTS AddressInfo;
 CREATE TABLE AddressInfo (
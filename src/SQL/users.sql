@@ -40,12 +40,24 @@
 
 REVOKE ALL ON DATABASE pingtraceroutedb FROM importer;
 REVOKE ALL ON Ping FROM importer;
+REVOKE ALL ON PingRollup FROM importer;
 REVOKE ALL ON Traceroute FROM importer;
+REVOKE ALL ON Path FROM importer;
+REVOKE ALL ON TracerouteRun FROM importer;
+REVOKE ALL ON LatestPing FROM importer;
+REVOKE ALL ON LatestPath FROM importer;
 DROP ROLE importer;
 CREATE ROLE importer WITH LOGIN ENCRYPTED PASSWORD '!importer!';
 GRANT CONNECT ON DATABASE pingtraceroutedb TO importer;
 GRANT INSERT ON TABLE Ping TO importer;
+GRANT SELECT, INSERT, UPDATE ON TABLE PingRollup TO importer;
 GRANT INSERT ON TABLE Traceroute TO importer;
+GRANT INSERT ON TABLE Path TO importer;
+GRANT INSERT ON TABLE TracerouteRun TO importer;
+GRANT SELECT, INSERT, UPDATE ON TABLE LatestPing TO importer;
+GRANT SELECT, INSERT, UPDATE ON TABLE LatestPath TO importer;
+GRANT EXECUTE ON FUNCTION createPartitions(TEXT, TEXT, TIMESTAMP WITHOUT TIME ZONE, TIMESTAMP WITHOUT TIME ZONE) TO importer;
+GRANT EXECUTE ON FUNCTION detachPartitions(TEXT, TIMESTAMP WITHOUT TIME ZONE) TO importer;
 
 
 REVOKE ALL ON DATABASE pingtraceroutedb FROM researcher;
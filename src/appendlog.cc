@@ -0,0 +1,305 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "appendlog.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/crc.hpp>
+
+
+const char   AppendLogWriter::Magic[8] = { 'H', 'P', 'C', 'T', 'L', 'O', 'G', 0x00 };
+const size_t AppendLogWriter::FrameHeaderSize;
+
+
+// ###### Compute CRC-32 of payload #########################################
+static inline uint32_t computeCRC32(const char* data, const size_t length)
+{
+   boost::crc_32_type crc;
+   crc.process_bytes(data, length);
+   return(crc.checksum());
+}
+
+
+
+// ###### Constructor #######################################################
+AppendLogWriter::AppendLogWriter()
+{
+   FD          = -1;
+   Segment     = nullptr;
+   SegmentSize = 0;
+   Position    = 0;
+   Records     = 0;
+}
+
+
+// ###### Destructor ########################################################
+AppendLogWriter::~AppendLogWriter()
+{
+   close();
+}
+
+
+// ###### Create new segment ################################################
+// The segment is prepared under a temporary name, and then renamed. So, a
+// segment is always visible with lock and header.
+bool AppendLogWriter::create(const std::string&         tempFileName,
+                             const std::string&         fileName,
+                             const size_t               segmentSize,
+                             const AppendLogContentType contentType,
+                             const uid_t                uid,
+                             const gid_t                gid)
+{
+   close();
+
+   // ====== Create and lock file ===========================================
+   FD = ::open(tempFileName.c_str(), O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+   if(FD < 0) {
+      HPCT_LOG(error) << "Unable to create " << tempFileName << ": " << strerror(errno);
+      return(false);
+   }
+   // The segment's blocks are allocated here. A sparse segment would raise
+   // SIGBUS on writing into the mapping, when the file system is full.
+   int result = (flock(FD, LOCK_EX|LOCK_NB) == 0) ? 0 : errno;
+   if(result == 0) {
+      result = posix_fallocate(FD, 0, segmentSize);   // Zero-filled
+   }
+   if(result != 0) {
+      HPCT_LOG(error) << "Unable to prepare " << tempFileName << ": " << strerror(result);
+      ::close(FD);
+      FD = -1;
+      unlink(tempFileName.c_str());
+      return(false);
+   }
+   if(fchown(FD, uid, gid) != 0) {
+      HPCT_LOG(warning) << "Setting ownership of " << tempFileName
+                        << " to UID " << uid << ", GID " << gid
+                        << " failed: " << strerror(errno);
+   }
+
+   // ====== Map file and write header ======================================
+   void* segment = mmap(nullptr, segmentSize, PROT_READ|PROT_WRITE, MAP_SHARED, FD, 0);
+   if(segment == MAP_FAILED) {
+      HPCT_LOG(error) << "Unable to map " << tempFileName << ": " << strerror(errno);
+      ::close(FD);
+      FD = -1;
+      unlink(tempFileName.c_str());
+      return(false);
+   }
+   Segment     = (char*)segment;
+   SegmentSize = segmentSize;
+   Position    = sizeof(AppendLogHeader);
+   Records     = 0;
+   AppendLogHeader* header = (AppendLogHeader*)Segment;
+   memcpy(&header->Magic, Magic, sizeof(Magic));
+   header->Version     = 1;
+   header->ContentType = contentType;
+   header->State       = ALS_Active;
+
+   // ====== Make segment visible ===========================================
+   if(rename(tempFileName.c_str(), fileName.c_str()) != 0) {
+      HPCT_LOG(error) << "Unable to rename " << tempFileName << ": " << strerror(errno);
+      close();
+      unlink(tempFileName.c_str());
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Append record #####################################################
+// Returns false, if the segment is full.
+bool AppendLogWriter::append(const char* data, const size_t length)
+{
+   const size_t frameSize = FrameHeaderSize + ((length + 3) & ~(size_t)3);
+   if( (Segment == nullptr) || (length == 0) || (length > 0xffffffff) ||
+       (Position + frameSize > SegmentSize) ) {
+      return(false);
+   }
+   char* frame = &Segment[Position];
+   memcpy(frame + FrameHeaderSize, data, length);
+   *(uint32_t*)(frame + 4) = computeCRC32(data, length);
+   // The length has to be written last, after all other data:
+   __atomic_store_n((uint32_t*)frame, (uint32_t)length, __ATOMIC_RELEASE);
+   Position += frameSize;
+   Records++;
+   return(true);
+}
+
+
+// ###### Close segment #####################################################
+void AppendLogWriter::close()
+{
+   if(Segment != nullptr) {
+      AppendLogHeader* header = (AppendLogHeader*)Segment;
+      header->DataEnd = Position;
+      __atomic_store_n(&header->State, (uint32_t)ALS_Closed, __ATOMIC_RELEASE);
+      // The segment is on disk, before it is handed over to the importer:
+      if(msync(Segment, SegmentSize, MS_SYNC) != 0) {
+         HPCT_LOG(error) << "Unable to synchronise append log segment: " << strerror(errno);
+      }
+      munmap(Segment, SegmentSize);
+      Segment = nullptr;
+
+      // Release the unused, preallocated space. A zero frame header is kept
+      // after the last record, so that a reader still mapping the full
+      // segment size does not access pages beyond the end of the file.
+      if(ftruncate(FD, std::min(Position + FrameHeaderSize, SegmentSize)) != 0) {
+         HPCT_LOG(warning) << "Unable to truncate append log segment: " << strerror(errno);
+      }
+   }
+   if(FD >= 0) {
+      ::close(FD);   // This also releases the lock
+      FD = -1;
+   }
+}
+
+
+
+// ###### Constructor #######################################################
+AppendLogReader::AppendLogReader()
+{
+   FD          = -1;
+   Segment     = nullptr;
+   SegmentSize = 0;
+   Position    = 0;
+}
+
+
+// ###### Destructor ########################################################
+AppendLogReader::~AppendLogReader()
+{
+   close();
+}
+
+
+// ###### Open segment ######################################################
+bool AppendLogReader::open(const std::string& fileName)
+{
+   close();
+
+   FD = ::open(fileName.c_str(), O_RDONLY);
+   struct stat status;
+   if( (FD < 0) || (fstat(FD, &status) != 0) ||
+       ((size_t)status.st_size < sizeof(AppendLogHeader)) ) {
+      close();
+      return(false);
+   }
+   void* segment = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, FD, 0);
+   if(segment == MAP_FAILED) {
+      close();
+      return(false);
+   }
+   Segment     = (const char*)segment;
+   SegmentSize = status.st_size;
+   Position    = sizeof(AppendLogHeader);
+
+   const AppendLogHeader* header = (const AppendLogHeader*)Segment;
+   if( (memcmp(header->Magic, AppendLogWriter::Magic, sizeof(AppendLogWriter::Magic)) != 0) ||
+       (header->Version != 1) ) {
+      close();
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Close segment #####################################################
+void AppendLogReader::close()
+{
+   if(Segment != nullptr) {
+      munmap((void*)Segment, SegmentSize);
+      Segment = nullptr;
+   }
+   if(FD >= 0) {
+      ::close(FD);
+      FD = -1;
+   }
+}
+
+
+// ###### Check whether the segment has been closed by its writer ###########
+bool AppendLogReader::isClosed() const
+{
+   const AppendLogHeader* header = (const AppendLogHeader*)Segment;
+   return(__atomic_load_n(&header->State, __ATOMIC_ACQUIRE) == ALS_Closed);
+}
+
+
+// ###### Check whether a writer is still writing into the segment ##########
+bool AppendLogReader::isLocked() const
+{
+   if(flock(FD, LOCK_SH|LOCK_NB) == 0) {
+      flock(FD, LOCK_UN);
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Get next record ###################################################
+// The record is returned in place, i.e. without copying.
+AppendLogReader::ReadResult AppendLogReader::next(const char*& data, size_t& length)
+{
+   if(Position + AppendLogWriter::FrameHeaderSize > SegmentSize) {
+      return(EndOfSegment);
+   }
+   const char* frame = &Segment[Position];
+   length = __atomic_load_n((const uint32_t*)frame, __ATOMIC_ACQUIRE);
+   if(length == 0) {
+      if(!isClosed()) {
+         return(NoData);
+      }
+      // The writer may have appended a last record before closing:
+      length = __atomic_load_n((const uint32_t*)frame, __ATOMIC_ACQUIRE);
+      if(length == 0) {
+         return(EndOfSegment);
+      }
+   }
+   const size_t frameSize = AppendLogWriter::FrameHeaderSize + ((length + 3) & ~(size_t)3);
+   if(Position + frameSize > SegmentSize) {
+      return(Corrupt);
+   }
+   data = frame + AppendLogWriter::FrameHeaderSize;
+   if(*(const uint32_t*)(frame + 4) != computeCRC32(data, length)) {
+      return(Corrupt);
+   }
+   Position += frameSize;
+   return(Record);
+}
@@ -0,0 +1,137 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef APPENDLOG_H
+#define APPENDLOG_H
+
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+
+// Append log segment format:
+// A segment is a file of fixed size, which is memory-mapped by the writer.
+// It begins with a 32-byte header (host byte order):
+//    Magic "HPCTLOG\0", Version (u32), ContentType (u32), State (u32),
+//    Reserved (u32), DataEnd (u64)
+// It is followed by the records, each framed by Length (u32) and CRC-32 of
+// the payload (u32), and padded to a multiple of 4 bytes. The writer writes
+// the Length field last. So, a reader sees a record either completely, or
+// a Length of 0. When the segment is closed, State becomes 1 and DataEnd is
+// the end of the last record. The file is then truncated after an empty
+// frame header following DataEnd.
+// While writing, the writer holds an exclusive flock() on the segment. An
+// unlocked segment in state 0 has been left by a crashed writer; it is valid
+// up to the last complete record.
+
+struct AppendLogHeader
+{
+   char     Magic[8];
+   uint32_t Version;
+   uint32_t ContentType;    // 0 = text lines, 1 = binary records
+   uint32_t State;          // 0 = active, 1 = closed
+   uint32_t Reserved;
+   uint64_t DataEnd;
+};
+
+enum AppendLogContentType {
+   ALCT_Text   = 0,
+   ALCT_Binary = 1
+};
+
+enum AppendLogState {
+   ALS_Active = 0,
+   ALS_Closed = 1
+};
+
+
+class AppendLogWriter
+{
+   public:
+   AppendLogWriter();
+   ~AppendLogWriter();
+
+   bool create(const std::string&         tempFileName,
+               const std::string&         fileName,
+               const size_t               segmentSize,
+               const AppendLogContentType contentType,
+               const uid_t                uid,
+               const gid_t                gid);
+   bool append(const char* data, const size_t length);
+   void close();
+
+   inline bool isOpen() const       { return(Segment != nullptr); }
+   inline size_t getUsed() const    { return(Position);           }
+   inline size_t getRecords() const { return(Records);            }
+
+   static const char   Magic[8];
+   static const size_t FrameHeaderSize = 8;
+
+   private:
+   int    FD;
+   char*  Segment;
+   size_t SegmentSize;
+   size_t Position;
+   size_t Records;
+};
+
+
+class AppendLogReader
+{
+   public:
+   enum ReadResult {
+      Record       = 0,   // Got a record
+      NoData       = 1,   // No further record yet (active segment)
+      EndOfSegment = 2,   // Segment is closed, and all records have been read
+      Corrupt      = 3    // Bad record
+   };
+
+   AppendLogReader();
+   ~AppendLogReader();
+
+   bool open(const std::string& fileName);
+   void close();
+   ReadResult next(const char*& data, size_t& length);
+
+   bool isClosed() const;
+   bool isLocked() const;
+   inline AppendLogContentType getContentType() const {
+      return((AppendLogContentType)((const AppendLogHeader*)Segment)->ContentType);
+   }
+
+   private:
+   int         FD;
+   const char* Segment;
+   size_t      SegmentSize;
+   size_t      Position;
+};
+
+#endif
@@ -0,0 +1,467 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "binaryresults.h"
+
+#include <cstring>
+
+
+const char          BinaryResultsEncoder::Magic[5] = { 'H', 'P', 'C', 'T', 'B' };
+const unsigned char BinaryResultsEncoder::Version;
+
+
+// ###### Append varint #####################################################
+static inline void appendVarint(std::string& output, uint64_t value)
+{
+   while(value >= 0x80) {
+      output += (char)((value & 0x7f) | 0x80);
+      value >>= 7;
+   }
+   output += (char)value;
+}
+
+
+// ###### Append zigzag-encoded signed varint ###############################
+static inline void appendSignedVarint(std::string& output, const int64_t value)
+{
+   appendVarint(output, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+
+// ###### Append address bytes ##############################################
+static void appendAddressBytes(std::string& output, const boost::asio::ip::address& address)
+{
+   if(address.is_v4()) {
+      const boost::asio::ip::address_v4::bytes_type bytes = address.to_v4().to_bytes();
+      output += (char)4;
+      output.append((const char*)bytes.data(), bytes.size());
+   }
+   else {
+      const boost::asio::ip::address_v6::bytes_type bytes = address.to_v6().to_bytes();
+      output += (char)6;
+      output.append((const char*)bytes.data(), bytes.size());
+   }
+}
+
+
+
+// ###### Constructor #######################################################
+BinaryResultsEncoder::BinaryResultsEncoder()
+{
+   reset();
+}
+
+
+// ###### Destructor ########################################################
+BinaryResultsEncoder::~BinaryResultsEncoder()
+{
+}
+
+
+// ###### Reset state for a new file ########################################
+void BinaryResultsEncoder::reset()
+{
+   HeaderWritten = false;
+   LastTimeStamp = 0;
+   AddressDictionary.clear();
+}
+
+
+// ###### Write header or source change #####################################
+void BinaryResultsEncoder::encodeSource(std::string&                    output,
+                                        const boost::asio::ip::address& source)
+{
+   if(!HeaderWritten) {
+      output.append(Magic, sizeof(Magic));
+      output += (char)Version;
+      appendAddressBytes(output, source);
+      AddressDictionary.insert(std::pair<boost::asio::ip::address, uint32_t>(source, 0));
+      Source        = source;
+      HeaderWritten = true;
+   }
+   else if(source != Source) {
+      // A shared results writer (--resultsshared) writes the results of
+      // all sources into one file:
+      output += 'S';
+      encodeAddress(output, source);
+      Source = source;
+   }
+}
+
+
+// ###### Write timestamp as difference to previous one #####################
+void BinaryResultsEncoder::encodeTimeStamp(std::string& output, const uint64_t timeStamp)
+{
+   appendSignedVarint(output, (int64_t)(timeStamp - LastTimeStamp));
+   LastTimeStamp = timeStamp;
+}
+
+
+// ###### Write address as dictionary reference #############################
+void BinaryResultsEncoder::encodeAddress(std::string&                    output,
+                                         const boost::asio::ip::address& address)
+{
+   std::map<boost::asio::ip::address, uint32_t>::const_iterator found =
+      AddressDictionary.find(address);
+   if(found != AddressDictionary.end()) {
+      appendVarint(output, found->second);
+   }
+   else {
+      // New address -> define it with the next index:
+      const uint32_t index = AddressDictionary.size();
+      AddressDictionary.insert(std::pair<boost::asio::ip::address, uint32_t>(address, index));
+      appendVarint(output, index);
+      appendAddressBytes(output, address);
+   }
+}
+
+
+// ###### Encode tuple ######################################################
+void BinaryResultsEncoder::encode(std::string& output, const std::string& tuple)
+{
+   if(!HeaderWritten) {
+      encodeSource(output, boost::asio::ip::address());
+   }
+   output += 'L';
+   appendVarint(output, tuple.size());
+   output += tuple;
+}
+
+
+// ###### Encode Ping result ################################################
+void BinaryResultsEncoder::encode(std::string& output, const PingRecord& record)
+{
+   encodeSource(output, record.Source);
+   output += 'P';
+   encodeAddress(output, record.Destination);
+   encodeTimeStamp(output, record.TimeStamp);
+   appendVarint(output, record.Checksum);
+   appendVarint(output, record.Status);
+   appendSignedVarint(output, record.RTT);
+   output += (char)record.TrafficClass;
+}
+
+
+// ###### Encode Traceroute result ##########################################
+void BinaryResultsEncoder::encode(std::string& output, const TracerouteRecord& record)
+{
+   encodeSource(output, record.Source);
+   output += 'T';
+   encodeAddress(output, record.Destination);
+   encodeTimeStamp(output, record.TimeStamp);
+   appendVarint(output, record.Round);
+   appendVarint(output, record.Checksum);
+   appendVarint(output, record.TotalHops);
+   appendVarint(output, record.StatusFlags);
+   for(unsigned int i = 0; i < 8; i++) {
+      output += (char)((record.PathHash >> (8 * i)) & 0xff);
+   }
+   output += (char)record.TrafficClass;
+   appendVarint(output, record.Hops.size());
+   for(std::vector<TracerouteHopRecord>::const_iterator iterator = record.Hops.begin();
+       iterator != record.Hops.end(); iterator++) {
+      appendVarint(output, iterator->Hop);
+      appendVarint(output, iterator->Status);
+      appendSignedVarint(output, iterator->RTT);
+      encodeAddress(output, iterator->Address);
+   }
+}
+
+
+
+// ###### Constructor #######################################################
+BinaryResultsReader::BinaryResultsReader(std::istream& input)
+   : Input(input)
+{
+   HeaderRead    = false;
+   LastTimeStamp = 0;
+}
+
+
+// ###### Destructor ########################################################
+BinaryResultsReader::~BinaryResultsReader()
+{
+}
+
+
+// ###### Read byte #########################################################
+bool BinaryResultsReader::readByte(unsigned char& value)
+{
+   const std::istream::int_type c = Input.rdbuf()->sbumpc();
+   if(c == std::istream::traits_type::eof()) {
+      return(false);
+   }
+   value = (unsigned char)c;
+   return(true);
+}
+
+
+// ###### Read varint #######################################################
+bool BinaryResultsReader::readVarint(uint64_t& value)
+{
+   unsigned char byte;
+   value = 0;
+   for(unsigned int shift = 0; shift < 64; shift += 7) {
+      if(!readByte(byte)) {
+         return(false);
+      }
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if((byte & 0x80) == 0) {
+         return(true);
+      }
+   }
+   return(false);   // Too long
+}
+
+
+// ###### Read zigzag-encoded signed varint #################################
+bool BinaryResultsReader::readSignedVarint(int64_t& value)
+{
+   uint64_t encoded;
+   if(!readVarint(encoded)) {
+      return(false);
+   }
+   value = (int64_t)(encoded >> 1) ^ -(int64_t)(encoded & 1);
+   return(true);
+}
+
+
+// ###### Read timestamp difference #########################################
+bool BinaryResultsReader::readTimeStamp(uint64_t& timeStamp)
+{
+   int64_t difference;
+   if(!readSignedVarint(difference)) {
+      return(false);
+   }
+   timeStamp     = LastTimeStamp + (uint64_t)difference;
+   LastTimeStamp = timeStamp;
+   return(true);
+}
+
+
+// ###### Read address family and bytes #####################################
+bool BinaryResultsReader::readAddressBytes(boost::asio::ip::address& address)
+{
+   unsigned char family;
+   if(!readByte(family)) {
+      return(false);
+   }
+   if(family == 4) {
+      boost::asio::ip::address_v4::bytes_type bytes;
+      if(Input.rdbuf()->sgetn((char*)bytes.data(), bytes.size()) != (std::streamsize)bytes.size()) {
+         return(false);
+      }
+      address = boost::asio::ip::address_v4(bytes);
+   }
+   else if(family == 6) {
+      boost::asio::ip::address_v6::bytes_type bytes;
+      if(Input.rdbuf()->sgetn((char*)bytes.data(), bytes.size()) != (std::streamsize)bytes.size()) {
+         return(false);
+      }
+      address = boost::asio::ip::address_v6(bytes);
+   }
+   else {
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Read address dictionary reference #################################
+bool BinaryResultsReader::readAddress(boost::asio::ip::address& address)
+{
+   uint64_t index;
+   if(!readVarint(index)) {
+      return(false);
+   }
+   if(index < AddressDictionary.size()) {
+      address = AddressDictionary[index];
+   }
+   else if(index == AddressDictionary.size()) {
+      if(!readAddressBytes(address)) {
+         return(false);
+      }
+      AddressDictionary.push_back(address);
+   }
+   else {
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Read file header ##################################################
+// If magicStarted is set, the first byte of the magic has already been read.
+bool BinaryResultsReader::readHeader(const bool magicStarted)
+{
+   char          magic[sizeof(BinaryResultsEncoder::Magic)];
+   unsigned char version;
+   magic[0] = BinaryResultsEncoder::Magic[0];
+   const std::streamsize offset = (magicStarted) ? 1 : 0;
+   if( (Input.rdbuf()->sgetn(&magic[offset], sizeof(magic) - offset) != (std::streamsize)sizeof(magic) - offset) ||
+       (memcmp(magic, BinaryResultsEncoder::Magic, sizeof(magic)) != 0) ) {
+      ErrorMessage = "Not a binary results file";
+      return(false);
+   }
+   if( (!readByte(version)) || (version != BinaryResultsEncoder::Version) ) {
+      ErrorMessage = "Unsupported binary results format version";
+      return(false);
+   }
+   if(!readAddressBytes(Source)) {
+      ErrorMessage = "Bad source address in header";
+      return(false);
+   }
+   AddressDictionary.clear();
+   AddressDictionary.push_back(Source);
+   LastTimeStamp = 0;
+   HeaderRead    = true;
+   return(true);
+}
+
+
+// ###### Record an error ###################################################
+BinaryResultsReader::RecordType BinaryResultsReader::fail(const std::string& message)
+{
+   ErrorMessage = message;
+   return(FormatError);
+}
+
+
+// ###### Read next record ##################################################
+BinaryResultsReader::RecordType BinaryResultsReader::next()
+{
+   // ====== Read header ====================================================
+   if(!HeaderRead) {
+      if(Input.rdbuf()->sgetc() == std::istream::traits_type::eof()) {
+         return(EndOfInput);   // Empty input
+      }
+      if(!readHeader(false)) {
+         return(FormatError);
+      }
+   }
+
+   // ====== Read records ===================================================
+   while(true) {
+      unsigned char type;
+      if(!readByte(type)) {
+         return(EndOfInput);
+      }
+      switch(type) {
+         case 'P': {
+            uint64_t      checksum;
+            uint64_t      status;
+            unsigned char trafficClass;
+            Ping.Source = Source;
+            if( (!readAddress(Ping.Destination)) ||
+                (!readTimeStamp(Ping.TimeStamp)) ||
+                (!readVarint(checksum)) ||
+                (!readVarint(status)) ||
+                (!readSignedVarint(Ping.RTT)) ||
+                (!readByte(trafficClass)) ) {
+               return(fail("Bad Ping record"));
+            }
+            Ping.Checksum     = (uint16_t)checksum;
+            Ping.Status       = (unsigned int)status;
+            Ping.TrafficClass = trafficClass;
+            return(PingResult);
+          }
+         case 'T': {
+            uint64_t      round;
+            uint64_t      checksum;
+            uint64_t      totalHops;
+            uint64_t      statusFlags;
+            unsigned char pathHashBytes[8];
+            unsigned char trafficClass;
+            uint64_t      hops;
+            Traceroute.Source = Source;
+            if( (!readAddress(Traceroute.Destination)) ||
+                (!readTimeStamp(Traceroute.TimeStamp)) ||
+                (!readVarint(round)) ||
+                (!readVarint(checksum)) ||
+                (!readVarint(totalHops)) ||
+                (!readVarint(statusFlags)) ||
+                (Input.rdbuf()->sgetn((char*)&pathHashBytes, 8) != 8) ||
+                (!readByte(trafficClass)) ||
+                (!readVarint(hops)) || (hops > 255) ) {
+               return(fail("Bad Traceroute record"));
+            }
+            Traceroute.Round        = (unsigned int)round;
+            Traceroute.Checksum     = (uint16_t)checksum;
+            Traceroute.TotalHops    = (unsigned int)totalHops;
+            Traceroute.StatusFlags  = (unsigned int)statusFlags;
+            Traceroute.TrafficClass = trafficClass;
+            Traceroute.PathHash     = 0;
+            for(unsigned int i = 0; i < 8; i++) {
+               Traceroute.PathHash |= (uint64_t)pathHashBytes[i] << (8 * i);
+            }
+            Traceroute.Hops.resize(hops);
+            for(std::vector<TracerouteHopRecord>::iterator iterator = Traceroute.Hops.begin();
+                iterator != Traceroute.Hops.end(); iterator++) {
+               uint64_t hop;
+               uint64_t status;
+               if( (!readVarint(hop)) ||
+                   (!readVarint(status)) ||
+                   (!readSignedVarint(iterator->RTT)) ||
+                   (!readAddress(iterator->Address)) ) {
+                  return(fail("Bad Traceroute hop"));
+               }
+               iterator->Hop    = (unsigned int)hop;
+               iterator->Status = (unsigned int)status;
+            }
+            return(TracerouteResult);
+          }
+         case 'L': {
+            uint64_t length;
+            if( (!readVarint(length)) || (length > 65536) ) {
+               return(fail("Bad line record"));
+            }
+            Tuple.resize(length);
+            if(Input.rdbuf()->sgetn(&Tuple[0], length) != (std::streamsize)length) {
+               return(fail("Bad line record"));
+            }
+            return(TupleLine);
+          }
+         case 'H':   // Header of concatenated file
+            if(!readHeader(true)) {
+               return(FormatError);
+            }
+          break;
+         case 'S':
+            if(!readAddress(Source)) {
+               return(fail("Bad source record"));
+            }
+          break;
+         default:
+            return(fail("Unknown record type"));
+          break;
+      }
+   }
+}
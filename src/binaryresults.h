@@ -0,0 +1,132 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef BINARYRESULTS_H
+#define BINARYRESULTS_H
+
+#include "resultsrecord.h"
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+
+// Binary results format:
+// The file begins with a header of the magic bytes "HPCTB", the format
+// version and the source address. It is followed by records, each beginning
+// with a type byte:
+// 'P' Ping:       destination, timestamp, checksum, status, RTT, traffic class
+// 'T' Traceroute: destination, timestamp, round, checksum, total hops,
+//                 status flags, path hash, traffic class, number of hops,
+//                 and per hop: hop, status, RTT, address
+// 'L' Line:       length, text of a plain text tuple
+// 'S' Source:     new source address for the following records
+//
+// Integers are written as varints (7 bits per byte, least significant bits
+// first). Timestamps are written as difference to the previous record's
+// timestamp, RTTs and timestamp differences as zigzag-encoded varints.
+// Addresses are written as index into a per-file address dictionary. Index 0
+// is the source address. An index equal to the current dictionary size
+// defines a new entry: it is followed by the address family (4 or 6) and the
+// address bytes. The path hash is written as 8 bytes in little-endian order;
+// the traffic class as a single byte.
+// A header may also occur in place of a record, i.e. concatenated files are
+// read as one file.
+
+class BinaryResultsEncoder
+{
+   public:
+   BinaryResultsEncoder();
+   ~BinaryResultsEncoder();
+
+   void reset();
+   void encode(std::string& output, const std::string& tuple);
+   void encode(std::string& output, const PingRecord& record);
+   void encode(std::string& output, const TracerouteRecord& record);
+
+   static const char          Magic[5];
+   static const unsigned char Version = 1;
+
+   private:
+   void encodeSource(std::string& output, const boost::asio::ip::address& source);
+   void encodeTimeStamp(std::string& output, const uint64_t timeStamp);
+   void encodeAddress(std::string& output, const boost::asio::ip::address& address);
+
+   bool                                         HeaderWritten;
+   boost::asio::ip::address                     Source;
+   uint64_t                                     LastTimeStamp;
+   std::map<boost::asio::ip::address, uint32_t> AddressDictionary;
+};
+
+
+class BinaryResultsReader
+{
+   public:
+   enum RecordType {
+      EndOfInput       = 0,
+      PingResult       = 1,
+      TracerouteResult = 2,
+      TupleLine        = 3,
+      FormatError      = 4
+   };
+
+   BinaryResultsReader(std::istream& input);
+   ~BinaryResultsReader();
+
+   RecordType next();
+   inline const PingRecord& ping() const             { return(Ping);         }
+   inline const TracerouteRecord& traceroute() const { return(Traceroute);   }
+   inline const std::string& tuple() const           { return(Tuple);        }
+   inline const std::string& error() const           { return(ErrorMessage); }
+
+   private:
+   bool readHeader(const bool magicStarted);
+   bool readByte(unsigned char& value);
+   bool readVarint(uint64_t& value);
+   bool readSignedVarint(int64_t& value);
+   bool readTimeStamp(uint64_t& timeStamp);
+   bool readAddressBytes(boost::asio::ip::address& address);
+   bool readAddress(boost::asio::ip::address& address);
+   RecordType fail(const std::string& message);
+
+   std::istream&                         Input;
+   bool                                  HeaderRead;
+   boost::asio::ip::address              Source;
+   uint64_t                              LastTimeStamp;
+   std::vector<boost::asio::ip::address> AddressDictionary;
+   PingRecord                            Ping;
+   TracerouteRecord                      Traceroute;
+   std::string                           Tuple;
+   std::string                           ErrorMessage;
+};
+
+#endif
@@ -51,6 +51,7 @@ const std::string& Burstping::getName() const
 
 // ###### Send one ICMP request to given destination ########################
 void Burstping::sendBurstICMPRequest(const DestinationInfo& destination,
+                                 const uint32_t         destinationID,
                                  const unsigned int     ttl,
                                  const unsigned int     round,
                                  uint32_t&              targetChecksum,
@@ -147,10 +148,9 @@ void Burstping::sendBurstICMPRequest(const DestinationInfo& destination,
       TotalPackets++;
 
       assert((targetChecksum & ~0xffff) == 0);
-      ResultEntry resultEntry(round, SeqNumber, ttl, (uint16_t)targetChecksum, sendTime,
-                              destination, Unknown);
-      std::pair<std::map<unsigned short, ResultEntry>::iterator, bool> result = ResultsMap.insert(std::pair<unsigned short, ResultEntry>(SeqNumber,resultEntry));
-      assert(result.second == true);
+      const bool added = Probes.add(SeqNumber, round, ttl, (uint16_t)targetChecksum, sendTime,
+                                    destinationID);
+      assert(added == true);
    }
 }
 
@@ -161,17 +161,20 @@ void Burstping::sendRequests()
    std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
 
    // ====== Send requests, if there are destination addresses ==============
-   if(Destinations.begin() != Destinations.end()) {
+   if(!Destinations.empty()) {
       // All packets of this request block (for each destination) use the same checksum.
       // The next block of requests may then use another checksum.
       uint32_t targetChecksum = ~0U;
-      for(std::set<DestinationInfo>::const_iterator destinationIterator = Destinations.begin();
-          destinationIterator != Destinations.end(); destinationIterator++) {
-         const DestinationInfo& destination = *destinationIterator;
+      for(size_t position = 0; position < Destinations.size(); position++) {
+         const DestinationInfo& destination   = Destinations.at(position);
+         const uint32_t         destinationID = Destinations.idAt(position);
+         if(!markProbed(destinationID)) {
+            continue;
+         }
          for(int i=1; i<=Burstping::Burst; i++)
          {
             // HPCT_LOG(info) << "Burst No. " << i << " of payload " << Burstping::Payload << std::endl;
-            sendBurstICMPRequest(destination, FinalMaxTTL, 0, targetChecksum, Burstping::Payload);
+            sendBurstICMPRequest(destination, destinationID, FinalMaxTTL, 0, targetChecksum, Burstping::Payload);
          }
       }
 
@@ -272,64 +275,73 @@ void Burstping::run()
 // ###### Process results ###################################################
 void Burstping::processResults()
 {
+   // ====== Get completed entries ==========================================
+   // Only completed entries are materialised as ResultEntry objects. They
+   // are removed from the probes table.
+   const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+   std::vector<ResultEntry> resultsArray;
+   for(unsigned int i = 0; i < Probes.window(); i++) {
+      if(Probes.isUsed(i)) {
+         if(Probes.status(i) != Unknown) {
+            resultsArray.push_back(Probes.entry(i, Destinations));
+         }
+
+         // ====== Time-out entries =========================================
+         else if(std::chrono::duration_cast<std::chrono::milliseconds>(now - Probes.sendTime(i)).count() >= Expiration) {
+            resultsArray.push_back(Probes.entry(i, Destinations));
+            resultsArray.back().setStatus(Timeout);
+            resultsArray.back().setReceiveTime(resultsArray.back().sendTime() + std::chrono::milliseconds(Expiration));
+         }
+         else {
+            continue;
+         }
+         Probes.remove(i);
+         if(OutstandingRequests > 0) {
+            OutstandingRequests--;
+         }
+      }
+   }
+
    // ====== Sort results ===================================================
    std::vector<ResultEntry*> resultsVector;
-   for(std::map<unsigned short, ResultEntry>::iterator iterator = ResultsMap.begin(); iterator != ResultsMap.end(); iterator++) {
-      resultsVector.push_back(&iterator->second);
+   resultsVector.reserve(resultsArray.size());
+   for(std::vector<ResultEntry>::iterator iterator = resultsArray.begin(); iterator != resultsArray.end(); iterator++) {
+      resultsVector.push_back(&(*iterator));
    }
    std::sort(resultsVector.begin(), resultsVector.end(), &comparePingResults);
 
    // ====== Process results ================================================
-   const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+   // The results are written as one batch.
+   std::vector<PingRecord> records;
    for(std::vector<ResultEntry*>::iterator iterator = resultsVector.begin(); iterator != resultsVector.end(); iterator++) {
       ResultEntry* resultEntry = *iterator;
 
-      // ====== Time-out entries ============================================
-      if( (resultEntry->status() == Unknown) &&
-          (std::chrono::duration_cast<std::chrono::milliseconds>(now - resultEntry->sendTime()).count() >= Expiration) ) {
-         resultEntry->setStatus(Timeout);
-         resultEntry->setReceiveTime(resultEntry->sendTime() + std::chrono::milliseconds(Expiration));
-      }
-
       // ====== Print completed entries =====================================
-      if(resultEntry->status() != Unknown) {
-         HPCT_LOG(trace) << getName() << ": " << *resultEntry;
+      HPCT_LOG(trace) << getName() << ": " << *resultEntry;
 
-         TotalResponses++;
+      TotalResponses++;
 
-         if(ResultCallback) {
-            ResultCallback(this, resultEntry);
-         }
-
-         if(ResultsOutput) {
-            ResultsOutput->insert(
-               str(boost::format("#P %s %s %x %x %d %d %x")
-                  % SourceAddress.to_string()
-                  % resultEntry->destinationAddress().to_string()
-                  % usSinceEpoch(resultEntry->sendTime())
-                  % resultEntry->checksum()
-                  % resultEntry->status()
-                  % std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count()
-                  % (unsigned int)resultEntry->destination().trafficClass()
-            ));
-         }
+      if(ResultCallback) {
+         ResultCallback(this, resultEntry);
       }
 
-      // ====== Remove completed entries ====================================
-      if(resultEntry->status() != Unknown) {
-         assert(ResultsMap.erase(resultEntry->seqNumber()) == 1);
-         if(OutstandingRequests > 0) {
-            OutstandingRequests--;
-         }
+      if(ResultsOutput) {
+         records.push_back(PingRecord());
+         PingRecord& record  = records.back();
+         record.Source       = SourceAddress;
+         record.Destination  = resultEntry->destinationAddress();
+         record.TimeStamp    = usSinceEpoch(resultEntry->sendTime());
+         record.Checksum     = resultEntry->checksum();
+         record.Status       = resultEntry->status();
+         record.RTT          = std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count();
+         record.TrafficClass = resultEntry->destination().trafficClass();
       }
    }
+   if(!records.empty()) {
+      ResultsOutput->insert(records);
+   }
 
    if(RemoveDestinationAfterRun == true) {
-      std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
-      DestinationIterator = Destinations.begin();
-      while(DestinationIterator != Destinations.end()) {
-         Destinations.erase(DestinationIterator);
-         DestinationIterator = Destinations.begin();
-      }
+      removeCompletedDestinations();
    }
 }
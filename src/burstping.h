@@ -31,6 +31,7 @@ class Burstping : public Ping
    // virtual void handleIntervalEvent(const boost::system::error_code& errorCode);
    void run();
    virtual void sendBurstICMPRequest(const DestinationInfo& destination,
+                        const uint32_t                 destinationID,
                         const unsigned int             ttl,
                         const unsigned int             round,
                         uint32_t&                      targetChecksum,
@@ -73,8 +73,8 @@ std::ostream& operator<<(std::ostream& os, const DestinationInfo& destinationInf
 
 
 // ###### Comparison operator ###############################################
-int operator<(const DestinationInfo& destinationInfo1,
-              const DestinationInfo& destinationInfo2)
+bool operator<(const DestinationInfo& destinationInfo1,
+               const DestinationInfo& destinationInfo2)
 {
    return ( (destinationInfo1.address() < destinationInfo2.address()) ||
             ( (destinationInfo1.address() == destinationInfo2.address()) &&
@@ -83,8 +83,8 @@ int operator<(const DestinationInfo& destinationInfo1,
 
 
 // ###### Comparison operator ###############################################
-int operator==(const DestinationInfo& destinationInfo1,
-               const DestinationInfo& destinationInfo2)
+bool operator==(const DestinationInfo& destinationInfo1,
+                const DestinationInfo& destinationInfo2)
 {
    return ( (destinationInfo1.address()      == destinationInfo2.address()) &&
             (destinationInfo1.trafficClass() == destinationInfo2.trafficClass()) );
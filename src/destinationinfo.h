@@ -42,6 +42,7 @@ class DestinationInfo {
    DestinationInfo(const boost::asio::ip::address& address,
                    const uint8_t                   trafficClassValue,
                    const uint32_t                  identifier = 0);
+   DestinationInfo& operator=(const DestinationInfo& destinationInfo) = default;
 
    inline uint32_t identifier() const {
       return(Identifier);
@@ -71,7 +72,7 @@ class DestinationInfo {
 
 
 std::ostream& operator<<(std::ostream& os, const DestinationInfo& destinationInfo);
-int operator<(const DestinationInfo& destinationInfo1, const DestinationInfo& destinationInfo2);
-int operator==(const DestinationInfo& destinationInfo1, const DestinationInfo& destinationInfo2);
+bool operator<(const DestinationInfo& destinationInfo1, const DestinationInfo& destinationInfo2);
+bool operator==(const DestinationInfo& destinationInfo1, const DestinationInfo& destinationInfo2);
 
 #endif
@@ -0,0 +1,216 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "destinationregistry.h"
+
+#include <cassert>
+
+
+const uint32_t DestinationRegistry::InvalidID;
+const size_t   DestinationRegistry::EndPosition;
+
+
+// ###### Constructor #######################################################
+DestinationRegistry::DestinationRegistry()
+{
+   SlotMask = 0;
+   rehash(64);
+}
+
+
+// ###### Destructor ########################################################
+DestinationRegistry::~DestinationRegistry()
+{
+}
+
+
+// ###### Remove all destinations ###########################################
+void DestinationRegistry::clear()
+{
+   DestinationArray.clear();
+   IDArray.clear();
+   PositionOfID.clear();
+   HashOfID.clear();
+   FreeIDs.clear();
+   rehash(64);
+}
+
+
+// ###### Add destination ###################################################
+uint32_t DestinationRegistry::insert(const DestinationInfo& destination, bool& inserted)
+{
+   const uint32_t found = find(destination);
+   if(found != InvalidID) {
+      inserted = false;
+      return(found);
+   }
+
+   // ====== Get ID =========================================================
+   uint32_t id;
+   if(!FreeIDs.empty()) {
+      id = FreeIDs.back();
+      FreeIDs.pop_back();
+   }
+   else {
+      id = PositionOfID.size();
+      assert(id != InvalidID);
+      PositionOfID.push_back(InvalidID);
+      HashOfID.push_back(0);
+   }
+
+   // ====== Store destination ==============================================
+   PositionOfID[id] = DestinationArray.size();
+   HashOfID[id]     = hash(destination);
+   DestinationArray.push_back(destination);
+   IDArray.push_back(id);
+
+   // ====== Update index, keeping the load factor below 1/2 ================
+   if(2 * DestinationArray.size() > Slots.size()) {
+      rehash(2 * Slots.size());
+   }
+   else {
+      insertIntoIndex(id);
+   }
+   inserted = true;
+   return(id);
+}
+
+
+// ###### Find destination ##################################################
+uint32_t DestinationRegistry::find(const DestinationInfo& destination) const
+{
+   size_t slot = hash(destination) & SlotMask;
+   while(Slots[slot] != InvalidID) {
+      const uint32_t id = Slots[slot];
+      if(DestinationArray[PositionOfID[id]] == destination) {
+         return(id);
+      }
+      slot = (slot + 1) & SlotMask;
+   }
+   return(InvalidID);
+}
+
+
+// ###### Remove destination at given position ##############################
+void DestinationRegistry::removeAt(const size_t position)
+{
+   assert(position < DestinationArray.size());
+   const uint32_t id = IDArray[position];
+   removeFromIndex(id);
+
+   // ====== Fill the gap with the last destination =========================
+   const size_t last = DestinationArray.size() - 1;
+   if(position != last) {
+      DestinationArray[position]      = DestinationArray[last];
+      IDArray[position]               = IDArray[last];
+      PositionOfID[IDArray[position]] = position;
+   }
+   DestinationArray.pop_back();
+   IDArray.pop_back();
+
+   // ====== Release ID =====================================================
+   PositionOfID[id] = InvalidID;
+   FreeIDs.push_back(id);
+}
+
+
+// ###### Hash function #####################################################
+uint32_t DestinationRegistry::hash(const DestinationInfo& destination)
+{
+   // NOTE: Like operator==(), this only covers address and traffic class.
+   uint64_t value;
+   if(destination.address().is_v4()) {
+      value = destination.address().to_v4().to_uint();
+   }
+   else {
+      const boost::asio::ip::address_v6::bytes_type bytes = destination.address().to_v6().to_bytes();
+      value = destination.address().to_v6().scope_id();
+      for(unsigned int i = 0; i < bytes.size(); i++) {
+         value = (value ^ bytes[i]) * 0x100000001b3ULL;   // FNV-1a
+      }
+   }
+   value = (value << 8) ^ destination.trafficClass();
+
+   // Finaliser of SplitMix64, to spread the bits over the whole value:
+   value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+   value = value ^ (value >> 31);
+   return((uint32_t)value);
+}
+
+
+// ###### Rebuild hash index ################################################
+void DestinationRegistry::rehash(const size_t slots)
+{
+   assert((slots & (slots - 1)) == 0);
+   Slots.assign(slots, InvalidID);
+   SlotMask = slots - 1;
+   for(size_t position = 0; position < IDArray.size(); position++) {
+      insertIntoIndex(IDArray[position]);
+   }
+}
+
+
+// ###### Add ID to hash index ##############################################
+void DestinationRegistry::insertIntoIndex(const uint32_t id)
+{
+   size_t slot = HashOfID[id] & SlotMask;
+   while(Slots[slot] != InvalidID) {
+      slot = (slot + 1) & SlotMask;
+   }
+   Slots[slot] = id;
+}
+
+
+// ###### Remove ID from hash index #########################################
+void DestinationRegistry::removeFromIndex(const uint32_t id)
+{
+   size_t slot = HashOfID[id] & SlotMask;
+   while(Slots[slot] != id) {
+      assert(Slots[slot] != InvalidID);
+      slot = (slot + 1) & SlotMask;
+   }
+
+   // ====== Backward-shift deletion ========================================
+   // Move following entries of the probe sequence into the gap, unless
+   // their home slot lies (cyclically) after the gap.
+   size_t gap  = slot;
+   size_t next = (gap + 1) & SlotMask;
+   while(Slots[next] != InvalidID) {
+      const size_t home = HashOfID[Slots[next]] & SlotMask;
+      if( ((next - home) & SlotMask) >= ((next - gap) & SlotMask) ) {
+         Slots[gap] = Slots[next];
+         gap        = next;
+      }
+      next = (next + 1) & SlotMask;
+   }
+   Slots[gap] = InvalidID;
+}
@@ -0,0 +1,104 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef DESTINATIONREGISTRY_H
+#define DESTINATIONREGISTRY_H
+
+#include "destinationinfo.h"
+
+#include <vector>
+
+
+// Set of destinations in contiguous storage. Each destination has a 32-bit
+// ID, which is stable until the destination is removed (IDs of removed
+// destinations are reused). Lookup is by an open-addressing hash index with
+// linear probing; removal shifts entries back instead of leaving tombstones.
+// Iteration is by position (0 to size() - 1). Removing a destination moves
+// the last one into its position.
+class DestinationRegistry
+{
+   public:
+   DestinationRegistry();
+   ~DestinationRegistry();
+
+   static const uint32_t InvalidID   = 0xffffffff;
+   static const size_t   EndPosition = ~((size_t)0);
+
+   uint32_t insert(const DestinationInfo& destination, bool& inserted);
+   uint32_t find(const DestinationInfo& destination) const;
+   void removeAt(const size_t position);
+   void clear();
+
+   inline size_t size()  const { return(DestinationArray.size());  }
+   inline bool   empty() const { return(DestinationArray.empty()); }
+   // Upper bound for IDs, e.g. for arrays of per-destination state:
+   inline size_t maxID() const { return(PositionOfID.size());      }
+
+   inline size_t first() const {
+      return((DestinationArray.empty()) ? EndPosition : 0);
+   }
+   inline size_t next(const size_t position) const {
+      return((position + 1 < DestinationArray.size()) ? position + 1 : EndPosition);
+   }
+   inline const DestinationInfo& at(const size_t position) const {
+      return(DestinationArray[position]);
+   }
+   inline uint32_t idAt(const size_t position) const {
+      return(IDArray[position]);
+   }
+   inline bool isValid(const uint32_t id) const {
+      return( (id < PositionOfID.size()) && (PositionOfID[id] != InvalidID) );
+   }
+   inline size_t positionOf(const uint32_t id) const {
+      return(PositionOfID[id]);
+   }
+
+   private:
+   static uint32_t hash(const DestinationInfo& destination);
+   void rehash(const size_t slots);
+   void insertIntoIndex(const uint32_t id);
+   void removeFromIndex(const uint32_t id);
+
+   // ====== Dense storage ==================================================
+   std::vector<DestinationInfo> DestinationArray;   // By position
+   std::vector<uint32_t>        IDArray;            // Position -> ID
+
+   // ====== Sparse ID map ==================================================
+   std::vector<uint32_t>        PositionOfID;       // ID -> position
+   std::vector<uint32_t>        HashOfID;           // ID -> hash value
+   std::vector<uint32_t>        FreeIDs;
+
+   // ====== Hash index =====================================================
+   std::vector<uint32_t>        Slots;              // IDs, InvalidID if free
+   size_t                       SlotMask;
+};
+
+#endif
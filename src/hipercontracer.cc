@@ -105,20 +105,38 @@ int main(int argc, char** argv)
    unsigned int       priority;
 
    unsigned long long tracerouteInterval;
+   unsigned long long tracerouteMaxInterval;
    unsigned int       tracerouteExpiration;
    unsigned int       tracerouteRounds;
    unsigned int       tracerouteInitialMaxTTL;
    unsigned int       tracerouteFinalMaxTTL;
    unsigned int       tracerouteIncrementMaxTTL;
+   bool               tracerouteTrigger;
+   unsigned int       tracerouteTriggerHoldOff;
 
    unsigned long long pingInterval;
    unsigned int       pingExpiration;
    unsigned int       pingTTL;
    unsigned int       pingPayload;
    unsigned int       pingBurst;
+   unsigned int       pingSummary;
+   bool               pingSummaryRaw;
 
    unsigned int       resultsTransactionLength;
    std::string        resultsDirectory;
+   std::string        resultsFormatName;
+   ResultsWriterFormat resultsFormat;
+   unsigned int       resultsQueueLength;
+   std::string        resultsCompressorName;
+   ResultsWriterCompressor resultsCompressor;
+   int                resultsZstdLevel;
+   unsigned int       resultsZstdWorkers;
+   std::string        resultsZstdDictionary;
+   unsigned int       resultsCompressionWorkers;
+   bool               resultsShared;
+   unsigned int       resultsAppendLog;
+   std::string        resultsCollector;
+   bool               resultsIndex;
 
    boost::program_options::options_description commandLineOptions;
    commandLineOptions.add_options()
@@ -164,6 +182,9 @@ int main(int argc, char** argv)
       ( "tracerouteinterval",
            boost::program_options::value<unsigned long long>(&tracerouteInterval)->default_value(10000),
            "Traceroute interval in ms" )
+      ( "traceroutemaxinterval",
+           boost::program_options::value<unsigned long long>(&tracerouteMaxInterval)->default_value(0),
+           "Traceroute maximum interval in ms for destinations with stable path (0 for fixed interval)" )
       ( "tracerouteduration",
            boost::program_options::value<unsigned int>(&tracerouteExpiration)->default_value(3000),
            "Traceroute duration in ms" )
@@ -179,6 +200,12 @@ int main(int argc, char** argv)
       ( "tracerouteincrementmaxttl",
            boost::program_options::value<unsigned int>(&tracerouteIncrementMaxTTL)->default_value(6),
            "Traceroute increment maximum TTL value" )
+      ( "traceroutetrigger",
+           boost::program_options::value<bool>(&tracerouteTrigger)->default_value(false)->implicit_value(true),
+           "Trigger traceroute on Ping RTT shift or loss" )
+      ( "traceroutetriggerholdoff",
+           boost::program_options::value<unsigned int>(&tracerouteTriggerHoldOff)->default_value(60),
+           "Traceroute trigger hold-off time per destination in s" )
 
       ( "pinginterval",
            boost::program_options::value<unsigned long long>(&pingInterval)->default_value(1000),
@@ -195,6 +222,12 @@ int main(int argc, char** argv)
       ( "pingburst",
            boost::program_options::value<unsigned int>(&pingBurst)->default_value(1),
            "Burstping initial burst value" )
+      ( "pingsummary",
+           boost::program_options::value<unsigned int>(&pingSummary)->default_value(0),
+           "Ping summary interval in s (0 for no summaries)" )
+      ( "pingsummaryraw",
+           boost::program_options::value<bool>(&pingSummaryRaw)->default_value(false)->implicit_value(true),
+           "Write single pings in addition to Ping summaries" )
 
       ( "resultsdirectory,R",
            boost::program_options::value<std::string>(&resultsDirectory)->default_value(std::string()),
@@ -202,6 +235,39 @@ int main(int argc, char** argv)
       ( "resultstransactionlength",
            boost::program_options::value<unsigned int>(&resultsTransactionLength)->default_value(60),
            "Results directory in s" )
+      ( "resultsformat",
+           boost::program_options::value<std::string>(&resultsFormatName)->default_value(std::string("text")),
+           "Results format (text, pathdictionary, binary or pgcopy)" )
+      ( "resultsshared",
+           boost::program_options::value<bool>(&resultsShared)->default_value(false)->implicit_value(true),
+           "Write results of all sources into shared results files" )
+      ( "resultsappendlog",
+           boost::program_options::value<unsigned int>(&resultsAppendLog)->default_value(0),
+           "Write results into memory-mapped append log segments of given size in MiB (0 for results files)" )
+      ( "resultscollector",
+           boost::program_options::value<std::string>(&resultsCollector)->default_value(std::string()),
+           "Send results to collector (host:port or unix:/path), instead of writing results files" )
+      ( "resultsindex",
+           boost::program_options::value<bool>(&resultsIndex)->default_value(false)->implicit_value(true),
+           "Write sidecar index file for each results file" )
+      ( "resultsqueuelength",
+           boost::program_options::value<unsigned int>(&resultsQueueLength)->default_value(4096),
+           "Results writer queue length (0 for writing in measurement thread)" )
+      ( "resultscompression",
+           boost::program_options::value<std::string>(&resultsCompressorName)->default_value(std::string("bzip2")),
+           "Results compression (none, gzip, bzip2 or zstd)" )
+      ( "resultszstdlevel",
+           boost::program_options::value<int>(&resultsZstdLevel)->default_value(3),
+           "Results Zstandard compression level" )
+      ( "resultszstdworkers",
+           boost::program_options::value<unsigned int>(&resultsZstdWorkers)->default_value(0),
+           "Results Zstandard compression worker threads" )
+      ( "resultszstddictionary",
+           boost::program_options::value<std::string>(&resultsZstdDictionary)->default_value(std::string()),
+           "Results Zstandard dictionary file" )
+      ( "resultscompressionworkers",
+           boost::program_options::value<unsigned int>(&resultsCompressionWorkers)->default_value(0),
+           "Results block-parallel BZip2/GZip compression worker threads" )
     ;
 
 
@@ -254,6 +320,73 @@ int main(int argc, char** argv)
       HPCT_LOG(fatal) << "Cannot find user!";
       return 1;
    }
+   if(resultsFormatName == "text") {
+      resultsFormat = PlainText;
+   }
+   else if(resultsFormatName == "pathdictionary") {
+      resultsFormat = PathDictionaryText;
+   }
+   else if(resultsFormatName == "binary") {
+      resultsFormat = Binary;
+   }
+   else if(resultsFormatName == "pgcopy") {
+      resultsFormat = PostgreSQLCopy;
+   }
+   else {
+      HPCT_LOG(fatal) << "Bad results format " << resultsFormatName << "!";
+      return 1;
+   }
+   if(resultsCompressorName == "none") {
+      resultsCompressor = None;
+   }
+   else if(resultsCompressorName == "gzip") {
+      resultsCompressor = GZip;
+   }
+   else if(resultsCompressorName == "bzip2") {
+      resultsCompressor = BZip2;
+   }
+   else if(resultsCompressorName == "zstd") {
+      resultsCompressor = ZStd;
+      if(ResultsWriter::configureZstd(resultsZstdLevel, resultsZstdWorkers,
+                                      resultsZstdDictionary) == false) {
+         HPCT_LOG(fatal) << "Unable to configure Zstandard compression!";
+         return 1;
+      }
+   }
+   else {
+      HPCT_LOG(fatal) << "Bad results compression " << resultsCompressorName << "!";
+      return 1;
+   }
+   if(resultsAppendLog > 0) {
+      if(resultsFormat == PostgreSQLCopy) {
+         HPCT_LOG(fatal) << "Append log does not support results format pgcopy!";
+         return 1;
+      }
+      resultsAppendLog = std::min(resultsAppendLog, 4096U);
+      ResultsWriter::configureAppendLog((size_t)resultsAppendLog << 20);
+   }
+   if(!resultsCollector.empty()) {
+      if( (resultsDirectory.empty()) || (resultsAppendLog > 0) ) {
+         HPCT_LOG(fatal) << "Collector needs results directory for spooling, and no append log!";
+         return 1;
+      }
+      if(ResultsWriter::configureCollector(resultsCollector,
+                                           resultsDirectory + "/spool",
+                                           (pw != nullptr) ? pw->pw_uid : 0,
+                                           (pw != nullptr) ? pw->pw_gid : 0) == false) {
+         HPCT_LOG(fatal) << "Unable to configure collector!";
+         return 1;
+      }
+   }
+   ResultsWriter::configureIndex(resultsIndex);
+   resultsCompressionWorkers = std::min(resultsCompressionWorkers, 256U);
+   if( (resultsCompressionWorkers > 0) &&
+       ((resultsCompressor == BZip2) || (resultsCompressor == GZip)) ) {
+      if(ResultsWriter::configureParallelCompression(resultsCompressionWorkers) == false) {
+         HPCT_LOG(fatal) << "Unable to configure parallel compression!";
+         return 1;
+      }
+   }
    if( (SourceArray.size() < 1) || (DestinationArray.size() < 1) ) {
       HPCT_LOG(fatal) << "At least one source and one destination are needed!";
       return 1;
@@ -265,22 +398,44 @@ int main(int argc, char** argv)
 
    std::srand(std::time(0));
    tracerouteInterval        = std::min(std::max(1000ULL, tracerouteInterval),   3600U*60000ULL);
+   if(tracerouteMaxInterval > 0) {
+      tracerouteMaxInterval  = std::min(std::max(tracerouteInterval, tracerouteMaxInterval), 7*24*3600U*1000ULL);
+   }
    tracerouteExpiration      = std::min(std::max(1000U, tracerouteExpiration),   60000U);
    tracerouteInitialMaxTTL   = std::min(std::max(1U, tracerouteInitialMaxTTL),   255U);
    tracerouteFinalMaxTTL     = std::min(std::max(1U, tracerouteFinalMaxTTL),     255U);
    tracerouteIncrementMaxTTL = std::min(std::max(1U, tracerouteIncrementMaxTTL), 255U);
+   tracerouteTriggerHoldOff  = std::min(tracerouteTriggerHoldOff,                 86400U);
+   if( (tracerouteTrigger) && ((servicePing == false) || (serviceTraceroute == false)) ) {
+      HPCT_LOG(fatal) << "Traceroute trigger needs Ping and Traceroute services!";
+      return 1;
+   }
    pingInterval              = std::min(std::max(100ULL, pingInterval),          3600U*60000ULL);
+   resultsQueueLength        = std::min(resultsQueueLength,                      1048576U);
    pingExpiration            = std::min(std::max(100U, pingExpiration),          3600U*60000U);
    pingTTL                   = std::min(std::max(1U, pingTTL),                   255U);
    pingPayload               = std::min(std::max(1U, pingPayload),               1500U);
    pingBurst                 = std::min(std::max(1U, pingBurst),                 1000U);
+   pingSummary               = std::min(pingSummary,                             86400U);
+   if( (pingSummary > 0) && (resultsFormat == PostgreSQLCopy) ) {
+      HPCT_LOG(fatal) << "Ping summaries are not supported by results format pgcopy!";
+      return 1;
+   }
    // $ chrt -m 
    priority                  = std::min(std::max(1U, priority),                  99U);
 
    if(!resultsDirectory.empty()) {
       HPCT_LOG(info) << "Results Output:" << std::endl
                      << "* Results Directory  = " << resultsDirectory         << std::endl
-                     << "* Transaction Length = " << resultsTransactionLength << " s";
+                     << "* Transaction Length = " << resultsTransactionLength << " s" << std::endl
+                     << "* Format             = " << resultsFormatName        << std::endl
+                     << "* Queue Length       = " << resultsQueueLength       << std::endl
+                     << "* Shared Files       = " << (resultsShared ? "yes" : "no") << std::endl
+                     << "* Append Log Segment = " << resultsAppendLog << " MiB" << std::endl
+                     << "* Sidecar Index      = " << (resultsIndex ? "yes" : "no") << std::endl
+                     << "* Collector          = " << (resultsCollector.empty() ? "none" : resultsCollector) << std::endl
+                     << "* Compression        = " << resultsCompressorName    << std::endl
+                     << "* Compr. Workers     = " << resultsCompressionWorkers;
    }
    else {
       HPCT_LOG(info) << "Results Output:" << std::endl
@@ -290,16 +445,21 @@ int main(int argc, char** argv)
       HPCT_LOG(info) << "Ping Service:" << std:: endl
                      << "* Interval           = " << pingInterval   << " ms" << std::endl
                      << "* Expiration         = " << pingExpiration << " ms" << std::endl
-                     << "* TTL                = " << pingTTL;
+                     << "* TTL                = " << pingTTL << std::endl
+                     << "* Summary Interval   = " << pingSummary << " s" << std::endl
+                     << "* Summary Raw Pings  = " << (pingSummaryRaw ? "yes" : "no");
    }
    if(serviceTraceroute) {
       HPCT_LOG(info) << "Traceroute Service:" << std:: endl
                      << "* Interval           = " << tracerouteInterval        << " ms" << std::endl
+                     << "* Max. Interval      = " << tracerouteMaxInterval     << " ms" << std::endl
                      << "* Expiration         = " << tracerouteExpiration      << " ms" << std::endl
                      << "* Rounds             = " << tracerouteRounds          << std::endl
                      << "* Initial MaxTTL     = " << tracerouteInitialMaxTTL   << std::endl
                      << "* Final MaxTTL       = " << tracerouteFinalMaxTTL     << std::endl
-                     << "* Increment MaxTTL   = " << tracerouteIncrementMaxTTL;
+                     << "* Increment MaxTTL   = " << tracerouteIncrementMaxTTL << std::endl
+                     << "* Trigger            = " << (tracerouteTrigger ? "on" : "off") << std::endl
+                     << "* Trigger Hold-Off   = " << tracerouteTriggerHoldOff  << " s";
    }
    if(serviceBurstping) {
       HPCT_LOG(info) << "Burstping Service:" << std:: endl
@@ -334,57 +494,70 @@ int main(int argc, char** argv)
       }
 */
 
-      if(servicePing) {
+      // NOTE: The Traceroute service has to be created first, since a Ping
+      // service may trigger traceroute runs.
+      Traceroute* tracerouteService = nullptr;
+      if(serviceTraceroute) {
          try {
             ResultsWriter* resultsWriter = nullptr;
             if(!resultsDirectory.empty()) {
-               resultsWriter = ResultsWriter::makeResultsWriter(ResultsWriterSet, sourceAddress, "Ping",
-                                                                resultsDirectory, resultsTransactionLength,
-                                                                (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0);
+               resultsWriter = ResultsWriter::makeResultsWriter(
+                                  ResultsWriterSet, sourceAddress, "Traceroute",
+                                  resultsDirectory, resultsTransactionLength,
+                                  (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0,
+                                  resultsCompressor, resultsFormat, resultsQueueLength,
+                                  resultsShared);
                if(resultsWriter == nullptr) {
                   HPCT_LOG(fatal) << "Cannot initialise results directory " << resultsDirectory << "!";
                   return 1;
                }
             }
-            Service* service = new Ping(resultsWriter, iterations, false,
-                                        sourceAddress, destinationsForSource,
-                                        pingInterval, pingExpiration, pingTTL, priority);
+            Traceroute* service = new Traceroute(resultsWriter, iterations, false,
+                                              sourceAddress, destinationsForSource,
+                                              tracerouteInterval, tracerouteExpiration,
+                                              tracerouteRounds,
+                                              tracerouteInitialMaxTTL, tracerouteFinalMaxTTL,
+                                              tracerouteIncrementMaxTTL, priority,
+                                              tracerouteMaxInterval);
             if(service->start() == false) {
                return 1;
             }
             ServiceSet.insert(service);
+            tracerouteService = service;
          }
          catch (std::exception& e) {
-            HPCT_LOG(fatal) << "Cannot create Ping service - " << e.what();
+            HPCT_LOG(fatal) << "Cannot create Traceroute service - " << e.what();
             return 1;
          }
       }
-      if(serviceTraceroute) {
+      if(servicePing) {
          try {
             ResultsWriter* resultsWriter = nullptr;
             if(!resultsDirectory.empty()) {
-               resultsWriter = ResultsWriter::makeResultsWriter(
-                                  ResultsWriterSet, sourceAddress, "Traceroute",
-                                  resultsDirectory, resultsTransactionLength,
-                                  (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0);
+               resultsWriter = ResultsWriter::makeResultsWriter(ResultsWriterSet, sourceAddress, "Ping",
+                                                                resultsDirectory, resultsTransactionLength,
+                                                                (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0,
+                                                                resultsCompressor, resultsFormat, resultsQueueLength,
+                                                                resultsShared);
                if(resultsWriter == nullptr) {
                   HPCT_LOG(fatal) << "Cannot initialise results directory " << resultsDirectory << "!";
                   return 1;
                }
             }
-            Service* service = new Traceroute(resultsWriter, iterations, false,
-                                              sourceAddress, destinationsForSource,
-                                              tracerouteInterval, tracerouteExpiration,
-                                              tracerouteRounds,
-                                              tracerouteInitialMaxTTL, tracerouteFinalMaxTTL,
-                                              tracerouteIncrementMaxTTL, priority);
+            Ping* service = new Ping(resultsWriter, iterations, false,
+                                     sourceAddress, destinationsForSource,
+                                     pingInterval, pingExpiration, pingTTL, priority);
+            if(tracerouteTrigger) {
+               service->setTracerouteTrigger(tracerouteService, tracerouteTriggerHoldOff);
+            }
+            service->setSummary(pingSummary, pingSummaryRaw);
             if(service->start() == false) {
                return 1;
             }
             ServiceSet.insert(service);
          }
          catch (std::exception& e) {
-            HPCT_LOG(fatal) << "Cannot create Traceroute service - " << e.what();
+            HPCT_LOG(fatal) << "Cannot create Ping service - " << e.what();
             return 1;
          }
       }
@@ -394,7 +567,9 @@ int main(int argc, char** argv)
             if(!resultsDirectory.empty()) {
                resultsWriter = ResultsWriter::makeResultsWriter(ResultsWriterSet, sourceAddress, "Burstping",
                                                                 resultsDirectory, resultsTransactionLength,
-                                                                (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0);
+                                                                (pw != nullptr) ? pw->pw_uid : 0, (pw != nullptr) ? pw->pw_gid : 0,
+                                                                resultsCompressor, resultsFormat, resultsQueueLength,
+                                                                resultsShared);
                if(resultsWriter == nullptr) {
                   HPCT_LOG(fatal) << "Cannot initialise results directory " << resultsDirectory << "!";
                   return 1;
@@ -430,14 +605,18 @@ int main(int argc, char** argv)
 
 
    // ====== Shut down service threads ======================================
+   // NOTE: All services have to be stopped before deleting any of them, since
+   // a Ping service may still trigger runs of a Traceroute service.
    for(std::set<Service*>::iterator serviceIterator = ServiceSet.begin(); serviceIterator != ServiceSet.end(); serviceIterator++) {
-      Service* service = *serviceIterator;
-      service->join();
-      delete service;
+      (*serviceIterator)->join();
+   }
+   for(std::set<Service*>::iterator serviceIterator = ServiceSet.begin(); serviceIterator != ServiceSet.end(); serviceIterator++) {
+      delete *serviceIterator;
    }
    for(std::set<ResultsWriter*>::iterator resultsWriterIterator = ResultsWriterSet.begin(); resultsWriterIterator != ResultsWriterSet.end(); resultsWriterIterator++) {
       delete *resultsWriterIterator;
    }
+   ResultsWriter::closeCollector();
 
    return(0);
 }
@@ -0,0 +1,376 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/program_options.hpp>
+
+#include "logger.h"
+#include "resultstransport.h"
+
+
+static boost::filesystem::path ResultsDirectory;
+static std::mutex              StoreMutex;
+static std::set<std::string>   RecentNames;
+static std::deque<std::string> RecentOrder;
+static const size_t            MaxRecentNames = 65536;
+
+// The names of the stored batches are also appended to a journal. So, a
+// batch sent again after its results file has been imported is recognised
+// as duplicate, even after restarting the collector. Batch names do not
+// start with ".", i.e. the journal cannot be overwritten by a batch.
+static boost::filesystem::path NamesFileName;
+static int                     NamesFD      = -1;
+static size_t                  NamesEntries = 0;
+
+
+// ###### Write file, and synchronise it to disk ############################
+static bool writeFile(const boost::filesystem::path& fileName,
+                      const std::string&             content)
+{
+   const int fd = open(fileName.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+   if(fd < 0) {
+      return(false);
+   }
+   size_t written = 0;
+   while(written < content.size()) {
+      const ssize_t result = write(fd, content.data() + written, content.size() - written);
+      if(result <= 0) {
+         close(fd);
+         return(false);
+      }
+      written += (size_t)result;
+   }
+   const bool success = (fsync(fd) == 0);
+   return( (close(fd) == 0) && (success) );
+}
+
+
+// ###### Synchronise directory to disk #####################################
+static bool syncDirectory(const boost::filesystem::path& directory)
+{
+   const int fd = open(directory.c_str(), O_RDONLY|O_DIRECTORY);
+   if(fd < 0) {
+      return(false);
+   }
+   const bool success = (fsync(fd) == 0);
+   return( (close(fd) == 0) && (success) );
+}
+
+
+// ###### Remember name for detecting duplicates ############################
+static void rememberName(const std::string& name)
+{
+   RecentNames.insert(name);
+   RecentOrder.push_back(name);
+   if(RecentOrder.size() > MaxRecentNames) {
+      RecentNames.erase(RecentOrder.front());
+      RecentOrder.pop_front();
+   }
+}
+
+
+// ###### Open names journal, and load the remembered names #################
+static bool openNamesJournal()
+{
+   std::ifstream namesFile(NamesFileName.string());
+   std::string   name;
+   while(std::getline(namesFile, name)) {
+      if(ResultsTransport::isValidName(name)) {   // Skip incomplete line
+         rememberName(name);
+         NamesEntries++;
+      }
+   }
+   NamesFD = open(NamesFileName.c_str(), O_WRONLY|O_CREAT|O_APPEND, 0644);
+   return(NamesFD >= 0);
+}
+
+
+// ###### Append name to names journal ######################################
+// When the journal has grown to twice the number of remembered names, it is
+// rewritten with the remembered names only.
+static bool journalName(const std::string& name)
+{
+   if(NamesEntries >= 2 * MaxRecentNames) {
+      std::string content;
+      for(std::deque<std::string>::const_iterator iterator = RecentOrder.begin();
+          iterator != RecentOrder.end(); iterator++) {
+         content += *iterator + "\n";
+      }
+      const boost::filesystem::path tempFileName = NamesFileName.string() + ".tmp";
+      boost::system::error_code     errorCode;
+      if(!writeFile(tempFileName, content)) {
+         return(false);
+      }
+      boost::filesystem::rename(tempFileName, NamesFileName, errorCode);
+      if(errorCode) {
+         return(false);
+      }
+      close(NamesFD);
+      NamesFD = open(NamesFileName.c_str(), O_WRONLY|O_APPEND);
+      if(NamesFD < 0) {
+         return(false);
+      }
+      NamesEntries = RecentOrder.size();
+      // The name has already been remembered, i.e. it is in the journal now.
+      return(syncDirectory(NamesFileName.parent_path()));
+   }
+
+   const std::string line = name + "\n";
+   if( (write(NamesFD, line.data(), line.size()) != (ssize_t)line.size()) ||
+       (fdatasync(NamesFD) != 0) ) {
+      return(false);
+   }
+   NamesEntries++;
+   return(true);
+}
+
+
+// ###### Store batch as results file #######################################
+// The batch is on disk, before it is acknowledged. A batch already stored,
+// or remembered in the names journal after the results file has been
+// imported, is a duplicate.
+static CollectorAcknowledgeStatus storeBatch(const std::string& name,
+                                             const std::string& content)
+{
+   const boost::filesystem::path tempFileName   = ResultsDirectory / "tmp" / name;
+   const boost::filesystem::path targetFileName = ResultsDirectory / name;
+
+   std::lock_guard<std::mutex> lock(StoreMutex);
+   if( (RecentNames.find(name) != RecentNames.end()) ||
+       (boost::filesystem::exists(targetFileName)) ) {
+      return(CAS_Duplicate);
+   }
+   if(!writeFile(tempFileName, content)) {
+      HPCT_LOG(error) << "Unable to write " << tempFileName << ": " << strerror(errno);
+      return(CAS_Rejected);
+   }
+   boost::system::error_code errorCode;
+   boost::filesystem::rename(tempFileName, targetFileName, errorCode);
+   if(errorCode) {
+      HPCT_LOG(error) << "Unable to rename " << tempFileName << ": " << errorCode.message();
+      return(CAS_Rejected);
+   }
+   if(!syncDirectory(ResultsDirectory)) {
+      HPCT_LOG(error) << "Unable to synchronise " << ResultsDirectory << ": " << strerror(errno);
+      return(CAS_Rejected);   // Sent again, then it is a duplicate
+   }
+
+   // ====== Remember name for detecting duplicates =========================
+   rememberName(name);
+   if(!journalName(name)) {
+      HPCT_LOG(warning) << "Unable to write " << name << " into " << NamesFileName
+                        << ": " << strerror(errno);
+   }
+   return(CAS_Stored);
+}
+
+
+// ###### Handle connection of a sender #####################################
+static void handleConnection(std::shared_ptr<boost::asio::generic::stream_protocol::socket> socket)
+{
+   boost::system::error_code errorCode;
+   std::string               name;
+   std::string               content;
+   while(true) {
+      // ====== Read batch ==================================================
+      char header[CollectorBatchHeaderSize];
+      boost::asio::read(*socket, boost::asio::buffer(header, sizeof(header)), errorCode);
+      if(errorCode) {
+         break;
+      }
+      const size_t   nameLength    = ResultsTransport::getUInt16(&header[2]);
+      const size_t   contentLength = ResultsTransport::getUInt32(&header[4]);
+      const uint32_t crc           = ResultsTransport::getUInt32(&header[8]);
+      if( (header[0] != CMT_Batch) ||
+          (nameLength == 0) || (nameLength > CollectorMaxNameLength) ||
+          (contentLength > CollectorMaxContentLength) ) {
+         HPCT_LOG(warning) << "Bad batch header -> closing connection";
+         break;
+      }
+      name.resize(nameLength);
+      content.resize(contentLength);
+      const std::vector<boost::asio::mutable_buffer> buffers = {
+         boost::asio::buffer(&name[0], nameLength),
+         boost::asio::buffer(&content[0], contentLength)
+      };
+      boost::asio::read(*socket, buffers, errorCode);
+      if(errorCode) {
+         break;
+      }
+
+      // ====== Store batch =================================================
+      CollectorAcknowledgeStatus status = CAS_Rejected;
+      if(!ResultsTransport::isValidName(name)) {
+         HPCT_LOG(warning) << "Rejected batch with bad name";
+      }
+      else if(ResultsTransport::computeCRC32(content) != crc) {
+         HPCT_LOG(warning) << "Rejected batch " << name << " with bad checksum";
+      }
+      else {
+         status = storeBatch(name, content);
+         if(status == CAS_Stored) {
+            HPCT_LOG(debug) << "Stored batch " << name << " (" << contentLength << " bytes)";
+         }
+         else if(status == CAS_Duplicate) {
+            HPCT_LOG(debug) << "Ignored duplicate batch " << name;
+         }
+         else {
+            HPCT_LOG(warning) << "Rejected batch " << name << " (unable to store it)";
+         }
+      }
+
+      // ====== Acknowledge batch ===========================================
+      std::string acknowledge(CollectorAcknowledgeHeaderSize, '\0');
+      acknowledge[0] = CMT_Acknowledge;
+      acknowledge[1] = (char)status;
+      ResultsTransport::putUInt16(&acknowledge[2], (uint16_t)nameLength);
+      acknowledge += name;
+      boost::asio::write(*socket, boost::asio::buffer(acknowledge), errorCode);
+      if(errorCode) {
+         break;
+      }
+   }
+   HPCT_LOG(debug) << "Connection closed";
+}
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   // ====== Initialize =====================================================
+   unsigned int logLevel;
+   std::string  listenAddress;
+   std::string  resultsDirectory;
+
+   boost::program_options::options_description commandLineOptions;
+   commandLineOptions.add_options()
+      ( "help,h",
+           "Print help message" )
+
+      ( "loglevel,L",
+           boost::program_options::value<unsigned int>(&logLevel)->default_value(boost::log::trivial::severity_level::info),
+           "Set logging level" )
+      ( "verbose,v",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::trace),
+           "Verbose logging level" )
+      ( "quiet,q",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::warning),
+           "Quiet logging level" )
+
+      ( "listen",
+           boost::program_options::value<std::string>(&listenAddress)->default_value(std::string("[::]:4718")),
+           "Listen address (host:port or unix:/path)" )
+      ( "resultsdirectory,R",
+           boost::program_options::value<std::string>(&resultsDirectory)->required(),
+           "Results directory" )
+    ;
+
+
+   // ====== Handle command-line arguments ==================================
+   boost::program_options::variables_map vm;
+   try {
+      boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+                                       style(
+                                          boost::program_options::command_line_style::style_t::default_style|
+                                          boost::program_options::command_line_style::style_t::allow_long_disguise
+                                       ).
+                                       options(commandLineOptions).
+                                       run(), vm);
+      if(vm.count("help")) {
+          std::cerr << "Usage: " << argv[0] << " -R results_directory [-l listen_address]" << std::endl
+                    << commandLineOptions;
+          return 1;
+      }
+      boost::program_options::notify(vm);
+   }
+   catch(std::exception& e) {
+      std::cerr << "ERROR: Bad parameter: " << e.what() << std::endl;
+      return 1;
+   }
+   initialiseLogger(logLevel);
+
+   ResultsDirectory = resultsDirectory;
+   try {
+      boost::filesystem::create_directories(ResultsDirectory / "tmp");
+   }
+   catch(std::exception const& e) {
+      HPCT_LOG(fatal) << "Unable to prepare results directory - " << e.what();
+      return 1;
+   }
+   NamesFileName = ResultsDirectory / "tmp" / ".collector-names";
+   if(!openNamesJournal()) {
+      HPCT_LOG(fatal) << "Unable to open " << NamesFileName << ": " << strerror(errno);
+      return 1;
+   }
+
+
+   // ====== Listen for senders =============================================
+   std::vector<boost::asio::generic::stream_protocol::endpoint> endpoints;
+   if(!ResultsTransport::resolveAddress(listenAddress, endpoints)) {
+      HPCT_LOG(fatal) << "Bad listen address " << listenAddress;
+      return 1;
+   }
+   if(listenAddress.compare(0, 5, "unix:") == 0) {
+      unlink(listenAddress.substr(5).c_str());
+   }
+   boost::asio::io_service ioService;
+   try {
+      boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol> acceptor(ioService, endpoints.front());
+      HPCT_LOG(info) << "Listening on " << listenAddress << ", storing results in " << ResultsDirectory;
+      while(true) {
+         std::shared_ptr<boost::asio::generic::stream_protocol::socket> socket(
+            new boost::asio::generic::stream_protocol::socket(ioService));
+         acceptor.accept(*socket);
+         HPCT_LOG(debug) << "Accepted connection";
+         std::thread(handleConnection, socket).detach();
+      }
+   }
+   catch(std::exception const& e) {
+      HPCT_LOG(fatal) << "Unable to listen on " << listenAddress << " - " << e.what();
+      return 1;
+   }
+   return 0;
+}
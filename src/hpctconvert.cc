@@ -0,0 +1,192 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/program_options.hpp>
+
+#include "binaryresults.h"
+#include "logger.h"
+#include "resultsformatter.h"
+
+
+// ###### Convert binary results into text format ###########################
+static bool convert(const std::string& inputName,
+                    std::istream&      inputStream,
+                    std::ostream&      outputStream)
+{
+   BinaryResultsReader reader(inputStream);
+   ResultsFormatter    formatter;
+   std::string         buffer;
+   while(true) {
+      buffer.clear();
+      switch(reader.next()) {
+         case BinaryResultsReader::PingResult:
+            formatter.formatPing(buffer, reader.ping());
+          break;
+         case BinaryResultsReader::TracerouteResult:
+            formatter.formatTraceroute(buffer, reader.traceroute());
+          break;
+         case BinaryResultsReader::TupleLine:
+            buffer += reader.tuple();
+            buffer += '\n';
+          break;
+         case BinaryResultsReader::EndOfInput:
+            return(true);
+          break;
+         default:
+            HPCT_LOG(error) << "Unable to convert " << inputName << ": " << reader.error();
+            return(false);
+          break;
+      }
+      outputStream.write(buffer.data(), buffer.size());
+   }
+}
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   // ====== Initialize =====================================================
+   unsigned int             logLevel;
+   std::string              outputFileName;
+   std::vector<std::string> inputFileNames;
+
+   boost::program_options::options_description commandLineOptions;
+   commandLineOptions.add_options()
+      ( "help,h",
+           "Print help message" )
+
+      ( "loglevel,L",
+           boost::program_options::value<unsigned int>(&logLevel)->default_value(boost::log::trivial::severity_level::info),
+           "Set logging level" )
+      ( "verbose,v",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::trace),
+           "Verbose logging level" )
+      ( "quiet,q",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::warning),
+           "Quiet logging level" )
+
+      ( "output,o",
+           boost::program_options::value<std::string>(&outputFileName),
+           "Text output file (default: standard output)" )
+      ( "input",
+           boost::program_options::value<std::vector<std::string>>(&inputFileNames),
+           "Binary results input file (default: standard input)" )
+    ;
+   boost::program_options::positional_options_description positionalOptions;
+   positionalOptions.add("input", -1);
+
+
+   // ====== Handle command-line arguments ==================================
+   boost::program_options::variables_map vm;
+   try {
+      boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+                                       style(
+                                          boost::program_options::command_line_style::style_t::default_style|
+                                          boost::program_options::command_line_style::style_t::allow_long_disguise
+                                       ).
+                                       options(commandLineOptions).
+                                       positional(positionalOptions).
+                                       run(), vm);
+      if(vm.count("help")) {
+          std::cerr << "Usage: " << argv[0] << " [-o output_file] [binary_results_file ...]" << std::endl
+                    << commandLineOptions;
+          return 1;
+      }
+      boost::program_options::notify(vm);
+   }
+   catch(std::exception& e) {
+      std::cerr << "ERROR: Bad parameter: " << e.what() << std::endl;
+      return 1;
+   }
+   initialiseLogger(logLevel);
+
+
+   // ====== Open output file ===============================================
+   std::ofstream outputFile;
+   if(!outputFileName.empty()) {
+      outputFile.open(outputFileName, std::ios_base::out | std::ios_base::binary);
+      if(!outputFile.is_open()) {
+         HPCT_LOG(fatal) << "Unable to create " << outputFileName;
+         return 1;
+      }
+   }
+   std::ostream& outputStream = (outputFile.is_open()) ? outputFile : std::cout;
+
+
+   // ====== Convert input files ============================================
+   if(inputFileNames.empty()) {
+      if(convert("standard input", std::cin, outputStream) == false) {
+         return 1;
+      }
+   }
+   for(std::vector<std::string>::const_iterator iterator = inputFileNames.begin();
+       iterator != inputFileNames.end(); iterator++) {
+      std::ifstream                       inputFile(*iterator, std::ios_base::in | std::ios_base::binary);
+      boost::iostreams::filtering_istream inputStream;
+      const std::string extension = boost::filesystem::path(*iterator).extension().string();
+      if(extension == ".bz2") {
+         inputStream.push(boost::iostreams::bzip2_decompressor());
+      }
+      else if(extension == ".gz") {
+         inputStream.push(boost::iostreams::gzip_decompressor());
+      }
+      inputStream.push(inputFile);
+      if(!inputFile.is_open()) {
+         HPCT_LOG(fatal) << "Unable to open " << *iterator;
+         return 1;
+      }
+      try {
+         if(convert(*iterator, inputStream, outputStream) == false) {
+            return 1;
+         }
+      }
+      catch(std::exception& e) {
+         HPCT_LOG(fatal) << "Unable to read " << *iterator << ": " << e.what();
+         return 1;
+      }
+   }
+
+   outputStream.flush();
+   if(!outputStream.good()) {
+      HPCT_LOG(fatal) << "Unable to write output";
+      return 1;
+   }
+   return 0;
+}
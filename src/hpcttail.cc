@@ -0,0 +1,187 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "appendlog.h"
+#include "logger.h"
+
+
+// ###### Get file name of the following segment ############################
+// Segment names end with "-<sequence number>.hpctlog".
+static std::string getNextSegmentName(const std::string& segmentName)
+{
+   const std::string suffix = ".hpctlog";
+   if( (segmentName.size() < suffix.size() + 9) ||
+       (segmentName.compare(segmentName.size() - suffix.size(), suffix.size(), suffix) != 0) ) {
+      return(std::string());
+   }
+   const size_t position = segmentName.size() - suffix.size() - 9;
+   try {
+      const unsigned long long seqNumber = std::stoull(segmentName.substr(position, 9));
+      return(segmentName.substr(0, position) +
+             str(boost::format("%09d") % (seqNumber + 1)) + suffix);
+   }
+   catch(std::exception& e) {
+      return(std::string());
+   }
+}
+
+
+// ###### Print records of segment ##########################################
+// Returns true, if the segment has been closed by its writer.
+static bool printSegment(const std::string& segmentName,
+                         const bool         follow)
+{
+   AppendLogReader reader;
+   if(!reader.open(segmentName)) {
+      HPCT_LOG(error) << "Unable to open append log segment " << segmentName;
+      return(false);
+   }
+   const char* data;
+   size_t      length;
+   while(true) {
+      switch(reader.next(data, length)) {
+         case AppendLogReader::Record:
+            std::cout.write(data, length);
+          break;
+         case AppendLogReader::NoData:
+            if(!reader.isLocked()) {
+               // The segment is still active, but there is no writer anymore:
+               HPCT_LOG(warning) << "Segment " << segmentName << " has not been closed by its writer";
+               return(false);
+            }
+            if(!follow) {
+               return(false);
+            }
+            std::cout.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          break;
+         case AppendLogReader::EndOfSegment:
+            return(true);
+          break;
+         default:
+            HPCT_LOG(error) << "Bad record in segment " << segmentName;
+            return(false);
+          break;
+      }
+   }
+}
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   // ====== Initialize =====================================================
+   unsigned int             logLevel;
+   bool                     follow;
+   std::vector<std::string> segmentNames;
+
+   boost::program_options::options_description commandLineOptions;
+   commandLineOptions.add_options()
+      ( "help,h",
+           "Print help message" )
+
+      ( "loglevel,L",
+           boost::program_options::value<unsigned int>(&logLevel)->default_value(boost::log::trivial::severity_level::info),
+           "Set logging level" )
+      ( "verbose,v",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::trace),
+           "Verbose logging level" )
+      ( "quiet,q",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::warning),
+           "Quiet logging level" )
+
+      ( "follow,f",
+           "Wait for new records, and continue with the following segments" )
+      ( "segment",
+           boost::program_options::value<std::vector<std::string>>(&segmentNames)->required(),
+           "Append log segment" )
+    ;
+   boost::program_options::positional_options_description positionalOptions;
+   positionalOptions.add("segment", -1);
+
+
+   // ====== Handle command-line arguments ==================================
+   boost::program_options::variables_map vm;
+   try {
+      boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+                                       style(
+                                          boost::program_options::command_line_style::style_t::default_style|
+                                          boost::program_options::command_line_style::style_t::allow_long_disguise
+                                       ).
+                                       options(commandLineOptions).
+                                       positional(positionalOptions).
+                                       run(), vm);
+      if(vm.count("help")) {
+          std::cerr << "Usage: " << argv[0] << " [-f] segment ..." << std::endl
+                    << commandLineOptions;
+          return 1;
+      }
+      boost::program_options::notify(vm);
+   }
+   catch(std::exception& e) {
+      std::cerr << "ERROR: Bad parameter: " << e.what() << std::endl;
+      return 1;
+   }
+   initialiseLogger(logLevel);
+   follow = (vm.count("follow") > 0);
+
+
+   // ====== Print segments =================================================
+   for(size_t i = 0; i < segmentNames.size(); i++) {
+      // Only the last segment is followed:
+      const bool followSegment = (follow) && (i + 1 == segmentNames.size());
+      std::string segmentName = segmentNames[i];
+      while( (printSegment(segmentName, followSegment)) && (followSegment) ) {
+         // ====== Wait for the following segment ===========================
+         segmentName = getNextSegmentName(segmentName);
+         if(segmentName.empty()) {
+            break;
+         }
+         HPCT_LOG(debug) << "Waiting for segment " << segmentName << " ...";
+         std::cout.flush();
+         while(!boost::filesystem::exists(segmentName)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+         }
+      }
+   }
+   std::cout.flush();
+   return 0;
+}
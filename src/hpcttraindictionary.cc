@@ -0,0 +1,212 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/program_options.hpp>
+
+#include <zdict.h>
+
+#include "logger.h"
+
+
+// ###### Read samples from results file ####################################
+// A sample is a block of complete results of up to sampleSize bytes. That is,
+// a #T line and its hop lines are kept together.
+static bool readSamples(const std::string&   fileName,
+                        const size_t         sampleSize,
+                        std::string&         samplesBuffer,
+                        std::vector<size_t>& sampleSizes)
+{
+   // ====== Open input file ================================================
+   std::ifstream                      inputFile(fileName, std::ios_base::in | std::ios_base::binary);
+   boost::iostreams::filtering_istream inputStream;
+   const std::string extension = boost::filesystem::path(fileName).extension().string();
+   if(extension == ".bz2") {
+      inputStream.push(boost::iostreams::bzip2_decompressor());
+   }
+   else if(extension == ".gz") {
+      inputStream.push(boost::iostreams::gzip_decompressor());
+   }
+   else if(extension != ".results") {
+      HPCT_LOG(error) << "Unsupported input file " << fileName
+                      << " (expecting .results, .results.bz2 or .results.gz)";
+      return(false);
+   }
+   inputStream.push(inputFile);
+   if(!inputFile.is_open()) {
+      HPCT_LOG(error) << "Unable to open " << fileName;
+      return(false);
+   }
+
+   // ====== Split into samples =============================================
+   try {
+      std::string sample;
+      std::string line;
+      while(std::getline(inputStream, line)) {
+         if( (line[0] == '#') && (sample.size() + line.size() + 1 > sampleSize) &&
+             (!sample.empty()) ) {
+            samplesBuffer += sample;
+            sampleSizes.push_back(sample.size());
+            sample.clear();
+         }
+         sample += line;
+         sample += '\n';
+      }
+      if(!sample.empty()) {
+         samplesBuffer += sample;
+         sampleSizes.push_back(sample.size());
+      }
+   }
+   catch(std::exception& e) {
+      HPCT_LOG(error) << "Unable to read " << fileName << ": " << e.what();
+      return(false);
+   }
+   return(true);
+}
+
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   // ====== Initialize =====================================================
+   unsigned int             logLevel;
+   std::string              outputFileName;
+   size_t                   dictionarySize;
+   size_t                   sampleSize;
+   std::vector<std::string> inputFileNames;
+
+   boost::program_options::options_description commandLineOptions;
+   commandLineOptions.add_options()
+      ( "help,h",
+           "Print help message" )
+
+      ( "loglevel,L",
+           boost::program_options::value<unsigned int>(&logLevel)->default_value(boost::log::trivial::severity_level::info),
+           "Set logging level" )
+      ( "verbose,v",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::trace),
+           "Verbose logging level" )
+      ( "quiet,q",
+           boost::program_options::value<unsigned int>(&logLevel)->implicit_value(boost::log::trivial::severity_level::warning),
+           "Quiet logging level" )
+
+      ( "output,o",
+           boost::program_options::value<std::string>(&outputFileName)->required(),
+           "Dictionary output file" )
+      ( "dictionarysize",
+           boost::program_options::value<size_t>(&dictionarySize)->default_value(112640),
+           "Maximum dictionary size in bytes" )
+      ( "samplesize",
+           boost::program_options::value<size_t>(&sampleSize)->default_value(4096),
+           "Sample size in bytes" )
+      ( "input",
+           boost::program_options::value<std::vector<std::string>>(&inputFileNames),
+           "Results input file" )
+    ;
+   boost::program_options::positional_options_description positionalOptions;
+   positionalOptions.add("input", -1);
+
+
+   // ====== Handle command-line arguments ==================================
+   boost::program_options::variables_map vm;
+   try {
+      boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+                                       style(
+                                          boost::program_options::command_line_style::style_t::default_style|
+                                          boost::program_options::command_line_style::style_t::allow_long_disguise
+                                       ).
+                                       options(commandLineOptions).
+                                       positional(positionalOptions).
+                                       run(), vm);
+      if(vm.count("help")) {
+          std::cerr << "Usage: " << argv[0] << " -o dictionary results_file ..." << std::endl
+                    << commandLineOptions;
+          return 1;
+      }
+      boost::program_options::notify(vm);
+   }
+   catch(std::exception& e) {
+      std::cerr << "ERROR: Bad parameter: " << e.what() << std::endl;
+      return 1;
+   }
+   initialiseLogger(logLevel);
+   dictionarySize = std::min(std::max((size_t)256, dictionarySize), (size_t)16*1024*1024);
+   sampleSize     = std::min(std::max((size_t)256, sampleSize),     (size_t)1024*1024);
+
+
+   // ====== Read samples ===================================================
+   std::string         samplesBuffer;
+   std::vector<size_t> sampleSizes;
+   for(std::vector<std::string>::const_iterator iterator = inputFileNames.begin();
+       iterator != inputFileNames.end(); iterator++) {
+      HPCT_LOG(debug) << "Reading " << *iterator << " ...";
+      if(readSamples(*iterator, sampleSize, samplesBuffer, sampleSizes) == false) {
+         return 1;
+      }
+   }
+   HPCT_LOG(info) << "Read " << sampleSizes.size() << " samples ("
+                  << samplesBuffer.size() << " bytes) from "
+                  << inputFileNames.size() << " files";
+
+
+   // ====== Train dictionary ===============================================
+   std::vector<char> dictionary(dictionarySize);
+   const size_t result = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+                                               samplesBuffer.data(),
+                                               sampleSizes.data(), sampleSizes.size());
+   if(ZDICT_isError(result)) {
+      HPCT_LOG(fatal) << "Unable to train dictionary: " << ZDICT_getErrorName(result)
+                      << " (more samples needed?)";
+      return 1;
+   }
+
+
+   // ====== Write dictionary ===============================================
+   std::ofstream outputFile(outputFileName, std::ios_base::out | std::ios_base::binary);
+   outputFile.write(dictionary.data(), result);
+   outputFile.close();
+   if(!outputFile.good()) {
+      HPCT_LOG(fatal) << "Unable to write dictionary " << outputFileName;
+      return 1;
+   }
+   HPCT_LOG(info) << "Wrote dictionary " << outputFileName << " (" << result << " bytes, ID "
+                  << ZDICT_getDictID(dictionary.data(), result) << ")";
+   return 0;
+}
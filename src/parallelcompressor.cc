@@ -0,0 +1,111 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "parallelcompressor.h"
+#include "logger.h"
+
+#include <functional>
+
+#include <boost/asio/post.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+
+unsigned int                              ParallelCompressor::Workers = 0;
+std::shared_ptr<boost::asio::thread_pool> ParallelCompressor::Pool;
+const size_t                              ParallelCompressor::BlockSize;
+
+
+// ###### Constructor #######################################################
+ParallelCompressor::ParallelCompressor(const Algorithm algorithm)
+   : State(new CompressorState)
+{
+   if(!Pool) {
+      throw std::ios_base::failure("Parallel compression has not been configured");
+   }
+   State->Method       = algorithm;
+   State->Uncompressed = 0;
+   State->Compressed   = 0;
+   State->Block.reserve(BlockSize);
+}
+
+
+// ###### Set up worker pool for all instances ##############################
+// NOTE: This has to be called before creating any instance!
+bool ParallelCompressor::configure(const unsigned int workers)
+{
+   if(Pool) {
+      HPCT_LOG(error) << "Parallel compression has already been configured";
+      return(false);
+   }
+   if(workers > 0) {
+      Workers = workers;
+      Pool    = std::shared_ptr<boost::asio::thread_pool>(new boost::asio::thread_pool(Workers));
+   }
+   return(true);
+}
+
+
+// ###### Hand current block over to the worker pool ########################
+void ParallelCompressor::submitBlock()
+{
+   State->PendingOffsets.push_back(State->Uncompressed);
+   State->Uncompressed += State->Block.size();
+
+   std::shared_ptr<std::packaged_task<std::string()>> task(
+      new std::packaged_task<std::string()>(
+         std::bind(&ParallelCompressor::compressBlock, State->Method, std::move(State->Block))));
+   State->Pending.push_back(task->get_future());
+   boost::asio::post(*Pool, [task]() { (*task)(); });
+
+   State->Block = std::string();
+   State->Block.reserve(BlockSize);
+}
+
+
+// ###### Compress block as independent stream ##############################
+std::string ParallelCompressor::compressBlock(const Algorithm algorithm, const std::string& block)
+{
+   std::string                         compressedBlock;
+   boost::iostreams::filtering_ostream outputStream;
+   if(algorithm == GZipBlocks) {
+      outputStream.push(boost::iostreams::gzip_compressor());
+   }
+   else {
+      outputStream.push(boost::iostreams::bzip2_compressor());
+   }
+   outputStream.push(boost::iostreams::back_inserter(compressedBlock));
+   outputStream.write(block.data(), block.size());
+   outputStream.reset();   // Flushes and closes the compressor
+   return(compressedBlock);
+}
@@ -0,0 +1,142 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef PARALLELCOMPRESSOR_H
+#define PARALLELCOMPRESSOR_H
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <ios>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/operations.hpp>
+
+
+// Boost Iostreams output filter for block-parallel BZip2 or GZip compression.
+// The data is split into blocks, which are compressed as independent streams
+// by a worker pool shared by all instances. The compressed blocks are written
+// in order, i.e. the output is a valid multi-stream BZip2 file or multi-member
+// GZip file, readable by the standard decompressors.
+class ParallelCompressor
+{
+   public:
+   enum Algorithm {
+      BZip2Blocks = 0,
+      GZipBlocks  = 1
+   };
+
+   typedef char char_type;
+   struct category : boost::iostreams::multichar_output_filter_tag,
+                     boost::iostreams::closable_tag { };
+
+   ParallelCompressor(const Algorithm algorithm);
+
+   static bool configure(const unsigned int workers);
+   static inline unsigned int getWorkers() { return(Workers); }
+
+   // Start offsets of the blocks written so far: uncompressed offset, and
+   // offset of the compressed block in the output. Decompression may start
+   // at any block.
+   inline const std::vector<std::pair<uint64_t, uint64_t>>& getBlockOffsets() const {
+      return(State->BlockOffsets);
+   }
+
+   // ====== Collect data into blocks =======================================
+   template<typename Sink> std::streamsize write(Sink&           sink,
+                                                 const char*     data,
+                                                 std::streamsize length) {
+      std::streamsize written = 0;
+      while(written < length) {
+         const std::streamsize n = std::min(length - written,
+                                            (std::streamsize)(BlockSize - State->Block.size()));
+         State->Block.append(data + written, n);
+         written += n;
+         if(State->Block.size() >= BlockSize) {
+            submitBlock();
+            writeBlocks(sink, false);
+         }
+      }
+      return(length);
+   }
+
+   // ====== Write all remaining blocks =====================================
+   template<typename Sink> void close(Sink& sink) {
+      if(!State->Block.empty()) {
+         submitBlock();
+      }
+      writeBlocks(sink, true);
+   }
+
+   private:
+   struct CompressorState {
+      Algorithm                                  Method;
+      std::string                                Block;
+      std::deque<std::future<std::string>>       Pending;          // In output order
+      std::deque<uint64_t>                       PendingOffsets;   // Uncompressed offsets
+      uint64_t                                   Uncompressed;
+      uint64_t                                   Compressed;
+      std::vector<std::pair<uint64_t, uint64_t>> BlockOffsets;
+   };
+
+   // ====== Write compressed blocks, in order ==============================
+   // Completed blocks at the front are written. Furthermore, the writer waits
+   // for the front block, if there are too many pending blocks.
+   template<typename Sink> void writeBlocks(Sink& sink, const bool all) {
+      while( (!State->Pending.empty()) &&
+             ( (all) ||
+               (State->Pending.size() > 2 * Workers) ||
+               (State->Pending.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready) ) ) {
+         const std::string compressedBlock = State->Pending.front().get();
+         State->Pending.pop_front();
+         State->BlockOffsets.push_back(std::make_pair(State->PendingOffsets.front(), State->Compressed));
+         State->PendingOffsets.pop_front();
+         State->Compressed += compressedBlock.size();
+         boost::iostreams::write(sink, compressedBlock.data(), compressedBlock.size());
+      }
+   }
+
+   void submitBlock();
+   static std::string compressBlock(const Algorithm algorithm, const std::string& block);
+
+   std::shared_ptr<CompressorState>                 State;
+
+   static unsigned int                              Workers;
+   static std::shared_ptr<boost::asio::thread_pool> Pool;
+   static const size_t                              BlockSize = 900000;   // BZip2 maximum block size
+};
+
+#endif
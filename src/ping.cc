@@ -33,9 +33,9 @@
 #include "tools.h"
 #include "logger.h"
 
+#include <cmath>
 #include <functional>
 #include <boost/bind.hpp>
-#include <boost/format.hpp>
 
 
 // ###### Constructor #######################################################
@@ -54,6 +54,10 @@ Ping::Ping(ResultsWriter*                   resultsWriter,
      PingInstanceName(std::string("Ping(") + sourceAddress.to_string() + std::string(")"))
 
 {
+   TracerouteTrigger = nullptr;
+   TriggerHoldOff    = 0;
+   SummaryInterval   = 0;
+   SummaryRaw        = true;
 }
 
 
@@ -70,6 +74,96 @@ const std::string& Ping::getName() const
 }
 
 
+// ###### Let RTT changes trigger traceroute runs ###########################
+// NOTE: This has to be set before start()!
+void Ping::setTracerouteTrigger(Traceroute* traceroute, const unsigned int holdOff)
+{
+   TracerouteTrigger = traceroute;
+   TriggerHoldOff    = holdOff;
+}
+
+
+// ###### Write summaries instead of (or in addition to) single pings ######
+// NOTE: This has to be set before start()!
+void Ping::setSummary(const unsigned int interval, const bool raw)
+{
+   SummaryInterval = interval;
+   SummaryRaw      = (interval == 0) || raw;
+}
+
+
+// ###### Join thread #######################################################
+void Ping::join()
+{
+   Traceroute::join();
+
+   // ====== Write summaries of the remaining intervals =====================
+   if( (ResultsOutput) && (SummaryInterval > 0) ) {
+      writeSummaries(true);
+   }
+}
+
+
+// ###### Initialise per-destination state of new (or reused) ID ############
+void Ping::initialiseDestinationState(const uint32_t destinationID)
+{
+   Traceroute::initialiseDestinationState(destinationID);
+   if(destinationID < ChangeDetectors.size()) {
+      ChangeDetectors[destinationID] = ChangeDetector();
+   }
+   if(destinationID < Probed.size()) {
+      Probed[destinationID] = false;
+   }
+}
+
+
+// ###### Mark destination as probed ########################################
+// With RemoveDestinationAfterRun, each destination is only pinged once.
+// Returns false, if it has already been pinged.
+bool Ping::markProbed(const uint32_t destinationID)
+{
+   if(RemoveDestinationAfterRun == true) {
+      if(destinationID >= Probed.size()) {
+         Probed.resize(Destinations.maxID(), false);
+      }
+      if(Probed[destinationID]) {
+         return(false);
+      }
+      Probed[destinationID] = true;
+   }
+   return(true);
+}
+
+
+// ###### Remove pinged destinations without outstanding probes #############
+// The probe table refers to the destinations by their IDs. So, a destination
+// is only removed after all of its probes have been completed.
+void Ping::removeCompletedDestinations()
+{
+   std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+
+   std::vector<bool> outstanding(Destinations.maxID(), false);
+   for(unsigned int i = 0; i < Probes.window(); i++) {
+      if(Probes.isUsed(i)) {
+         outstanding[Probes.destinationID(i)] = true;
+      }
+   }
+
+   // The last destination is moved into the position of a removed one.
+   // Then, it has already been checked.
+   size_t position = Destinations.size();
+   while(position > 0) {
+      position--;
+      const uint32_t destinationID = Destinations.idAt(position);
+      if( (destinationID < Probed.size()) && (Probed[destinationID]) &&
+          (!outstanding[destinationID]) ) {
+         removeDestinationAt(position);
+      }
+   }
+   DestinationPosition = DestinationRegistry::EndPosition;
+}
+
+
 // ###### All requests have received a response #############################
 void Ping::noMoreOutstandingRequests()
 {
@@ -92,7 +186,7 @@ bool Ping::prepareRun(const bool newRound)
    }
 
    RunStartTimeStamp = std::chrono::steady_clock::now();
-   return(Destinations.begin() == Destinations.end());
+   return(Destinations.empty());
 }
 
 
@@ -131,62 +225,257 @@ int Ping::comparePingResults(const ResultEntry* a, const ResultEntry* b)
 // ###### Process results ###################################################
 void Ping::processResults()
 {
+   // ====== Get completed entries ==========================================
+   // Only completed entries are materialised as ResultEntry objects. They
+   // are removed from the probes table.
+   const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+   std::vector<ResultEntry> resultsArray;
+   for(unsigned int i = 0; i < Probes.window(); i++) {
+      if(Probes.isUsed(i)) {
+         if(Probes.status(i) != Unknown) {
+            resultsArray.push_back(Probes.entry(i, Destinations));
+         }
+
+         // ====== Time-out entries =========================================
+         else if(std::chrono::duration_cast<std::chrono::milliseconds>(now - Probes.sendTime(i)).count() >= Expiration) {
+            resultsArray.push_back(Probes.entry(i, Destinations));
+            resultsArray.back().setStatus(Timeout);
+            resultsArray.back().setReceiveTime(resultsArray.back().sendTime() + std::chrono::milliseconds(Expiration));
+         }
+         else {
+            continue;
+         }
+         Probes.remove(i);
+         if(OutstandingRequests > 0) {
+            OutstandingRequests--;
+         }
+      }
+   }
+
    // ====== Sort results ===================================================
    std::vector<ResultEntry*> resultsVector;
-   for(std::map<unsigned short, ResultEntry>::iterator iterator = ResultsMap.begin(); iterator != ResultsMap.end(); iterator++) {
-      resultsVector.push_back(&iterator->second);
+   resultsVector.reserve(resultsArray.size());
+   for(std::vector<ResultEntry>::iterator iterator = resultsArray.begin(); iterator != resultsArray.end(); iterator++) {
+      resultsVector.push_back(&(*iterator));
    }
    std::sort(resultsVector.begin(), resultsVector.end(), &comparePingResults);
 
    // ====== Process results ================================================
-   const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+   // The results are written as one batch.
+   std::vector<PingRecord> records;
    for(std::vector<ResultEntry*>::iterator iterator = resultsVector.begin(); iterator != resultsVector.end(); iterator++) {
       ResultEntry* resultEntry = *iterator;
 
-      // ====== Time-out entries ============================================
-      if( (resultEntry->status() == Unknown) &&
-          (std::chrono::duration_cast<std::chrono::milliseconds>(now - resultEntry->sendTime()).count() >= Expiration) ) {
-         resultEntry->setStatus(Timeout);
-         resultEntry->setReceiveTime(resultEntry->sendTime() + std::chrono::milliseconds(Expiration));
+      // ====== Print completed entries =====================================
+      HPCT_LOG(trace) << getName() << ": " << *resultEntry;
+
+      if(ResultCallback) {
+         ResultCallback(this, resultEntry);
       }
 
-      // ====== Print completed entries =====================================
-      if(resultEntry->status() != Unknown) {
-         HPCT_LOG(trace) << getName() << ": " << *resultEntry;
+      if(TracerouteTrigger) {
+         detectChange(*resultEntry);
+      }
 
-         if(ResultCallback) {
-            ResultCallback(this, resultEntry);
-         }
+      if( (ResultsOutput) && (SummaryInterval > 0) ) {
+         addToSummary(*resultEntry);
+      }
+      if( (ResultsOutput) && (SummaryRaw) ) {
+         records.push_back(PingRecord());
+         PingRecord& record  = records.back();
+         record.Source       = SourceAddress;
+         record.Destination  = resultEntry->destinationAddress();
+         record.TimeStamp    = usSinceEpoch(resultEntry->sendTime());
+         record.Checksum     = resultEntry->checksum();
+         record.Status       = resultEntry->status();
+         record.RTT          = std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count();
+         record.TrafficClass = resultEntry->destination().trafficClass();
+      }
+   }
+   if(!records.empty()) {
+      ResultsOutput->insert(records);
+   }
+   if( (ResultsOutput) && (SummaryInterval > 0) ) {
+      writeSummaries(false);
+   }
+
+   if(RemoveDestinationAfterRun == true) {
+      removeCompletedDestinations();
+   }
+}
+
+
+// ###### Add result to the summary of its interval #########################
+// A ping belongs to the interval of its send time.
+void Ping::addToSummary(const ResultEntry& resultEntry)
+{
+   std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+
+   const uint32_t destinationID = resultEntry.destinationID();
+   if(!Destinations.isValid(destinationID)) {
+      return;   // Destination has already been removed
+   }
+   const DestinationInfo& destination =
+      Destinations.at(Destinations.positionOf(destinationID));
+   const uint64_t timeStamp     = usSinceEpoch(resultEntry.sendTime());
+   const uint64_t length        = SummaryInterval * 1000000ULL;
+   const uint64_t intervalStart = timeStamp - (timeStamp % length);
+
+   std::vector<PingSummaryRecord>& summaries = Summaries[intervalStart];
+   if(destinationID >= summaries.size()) {
+      summaries.resize(destinationID + 1);   // Value-initialised: Probes == 0
+   }
+   PingSummaryRecord& summary = summaries[destinationID];
+
+   // ====== Complete the summary of a removed destination ==================
+   // The ID of a removed destination may have been reused. Then, the summary
+   // of the removed destination is complete.
+   if( (summary.Probes > 0) &&
+       ((summary.Destination  != destination.address()) ||
+        (summary.TrafficClass != destination.trafficClass())) ) {
+      CompletedSummaries.push_back(summary);
+      summary.Probes = 0;
+   }
+
+   // ====== Begin a new summary ============================================
+   if(summary.Probes == 0) {
+      summary.Source       = SourceAddress;
+      summary.Destination  = destination.address();
+      summary.TimeStamp    = intervalStart;
+      summary.Interval     = SummaryInterval;
+      summary.TrafficClass = destination.trafficClass();
+      summary.Lost         = 0;
+      summary.MinRTT       = -1;
+      summary.MaxRTT       = -1;
+      summary.SumRTT       = 0;
+      summary.SumSqRTT     = 0.0;
+      summary.Sketch.clear();
+   }
+
+   summary.Probes++;
+   if(resultEntry.status() != Success) {
+      summary.Lost++;
+   }
+   else {
+      const int64_t rtt = std::chrono::duration_cast<std::chrono::microseconds>(resultEntry.receiveTime() - resultEntry.sendTime()).count();
+      if( (summary.MinRTT < 0) || (rtt < summary.MinRTT) ) {
+         summary.MinRTT = rtt;
+      }
+      if(rtt > summary.MaxRTT) {
+         summary.MaxRTT = rtt;
+      }
+      summary.SumRTT   += rtt;
+      summary.SumSqRTT += (double)rtt * (double)rtt;
+      summary.Sketch.add(rtt);
+   }
+}
 
-         if(ResultsOutput) {
-            ResultsOutput->insert(
-               str(boost::format("#P %s %s %x %x %d %d %x")
-                  % SourceAddress.to_string()
-                  % resultEntry->destinationAddress().to_string()
-                  % usSinceEpoch(resultEntry->sendTime())
-                  % resultEntry->checksum()
-                  % resultEntry->status()
-                  % std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count()
-                  % (unsigned int)resultEntry->destination().trafficClass()
-            ));
+
+// ###### Write summaries of completed intervals ############################
+// An interval is complete, when its last pings have expired, and the
+// expiration has been noticed by the next run.
+void Ping::writeSummaries(const bool all)
+{
+   const uint64_t now    = usSinceEpoch(std::chrono::system_clock::now());
+   const uint64_t length = SummaryInterval * 1000000ULL;
+   const uint64_t delay  = 1000ULL * (Expiration + Interval);
+
+   std::vector<PingSummaryRecord> records(CompletedSummaries.begin(),
+                                          CompletedSummaries.end());
+   CompletedSummaries.clear();
+   std::map<uint64_t, std::vector<PingSummaryRecord>>::iterator iterator = Summaries.begin();
+   while(iterator != Summaries.end()) {
+      if( (!all) && (iterator->first + length + delay > now) ) {
+         break;
+      }
+      for(std::vector<PingSummaryRecord>::const_iterator summaryIterator = iterator->second.begin();
+          summaryIterator != iterator->second.end(); summaryIterator++) {
+         if(summaryIterator->Probes > 0) {
+            records.push_back(*summaryIterator);
          }
       }
+      Summaries.erase(iterator++);
+   }
+   if(!records.empty()) {
+      ResultsOutput->insert(records);
+   }
+}
 
-      // ====== Remove completed entries ====================================
-      if(resultEntry->status() != Unknown) {
-         assert(ResultsMap.erase(resultEntry->seqNumber()) == 1);
-         if(OutstandingRequests > 0) {
-            OutstandingRequests--;
+
+// ###### Detect RTT shift or loss burst, and trigger traceroute ############
+void Ping::detectChange(const ResultEntry& resultEntry)
+{
+   // Only the destination's responses and time-outs are used here. Then, the
+   // result's address is the destination address.
+   if( (resultEntry.status() != Success) && (resultEntry.status() != Timeout) ) {
+      return;
+   }
+   std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+   const uint32_t destinationID = resultEntry.destinationID();
+   if(!Destinations.isValid(destinationID)) {
+      return;   // Destination has already been removed
+   }
+   if(destinationID >= ChangeDetectors.size()) {
+      ChangeDetectors.resize(Destinations.maxID());
+   }
+   ChangeDetector& detector = ChangeDetectors[destinationID];
+   bool            changed  = false;
+
+   // ====== Loss burst =====================================================
+   if(resultEntry.status() == Timeout) {
+      detector.LostInRow++;
+      changed = (detector.LostInRow == TriggerLossBurst);
+   }
+
+   // ====== RTT level shift ================================================
+   else {
+      const double rtt = std::chrono::duration_cast<std::chrono::microseconds>(resultEntry.rtt()).count();
+      if(detector.LostInRow >= TriggerLossBurst) {
+         changed = true;   // Destination is reachable again after loss burst
+      }
+      detector.LostInRow = 0;
+
+      if(detector.Samples >= TriggerWarmUp) {
+         const double threshold  = std::max(std::max(4.0 * detector.MeanDeviation,
+                                                     0.25 * detector.MeanRTT), 1000.0);
+         const double difference = rtt - detector.MeanRTT;
+         if(std::fabs(difference) > threshold) {
+            const int direction = (difference > 0.0) ? 1 : -1;
+            detector.ShiftsInRow    = (direction == detector.ShiftDirection) ? detector.ShiftsInRow + 1 : 1;
+            detector.ShiftDirection = direction;
+         }
+         else {
+            detector.ShiftsInRow = 0;
+         }
+         if(detector.ShiftsInRow >= TriggerShiftLength) {
+            // Restart with the new RTT level:
+            changed                 = true;
+            detector.Samples        = 0;
+            detector.ShiftsInRow    = 0;
+            detector.ShiftDirection = 0;
          }
       }
+
+      // Smoothing as for TCP's RTO computation (RFC 6298):
+      if(detector.Samples == 0) {
+         detector.MeanRTT       = rtt;
+         detector.MeanDeviation = rtt / 2.0;
+      }
+      else {
+         detector.MeanDeviation = 0.75 * detector.MeanDeviation + 0.25 * std::fabs(detector.MeanRTT - rtt);
+         detector.MeanRTT       = 0.875 * detector.MeanRTT + 0.125 * rtt;
+      }
+      detector.Samples++;
    }
 
-   if(RemoveDestinationAfterRun == true) {
-      std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
-      DestinationIterator = Destinations.begin();
-      while(DestinationIterator != Destinations.end()) {
-         Destinations.erase(DestinationIterator);
-         DestinationIterator = Destinations.begin();
+   // ====== Trigger traceroute, at most once per hold-off time =============
+   if(changed) {
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if(now - detector.LastTrigger >= std::chrono::seconds(TriggerHoldOff)) {
+         detector.LastTrigger = now;
+         if(TracerouteTrigger->triggerDestination(resultEntry.destination())) {
+            HPCT_LOG(debug) << getName() << ": Triggered traceroute to " << resultEntry.destination();
+         }
       }
    }
 }
@@ -198,14 +487,16 @@ void Ping::sendRequests()
    std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
 
    // ====== Send requests, if there are destination addresses ==============
-   if(Destinations.begin() != Destinations.end()) {
+   if(!Destinations.empty()) {
       // All packets of this request block (for each destination) use the same checksum.
       // The next block of requests may then use another checksum.
       uint32_t targetChecksum = ~0U;
-      for(std::set<DestinationInfo>::const_iterator destinationIterator = Destinations.begin();
-          destinationIterator != Destinations.end(); destinationIterator++) {
-         const DestinationInfo& destination = *destinationIterator;
-         sendICMPRequest(destination, FinalMaxTTL, 0, targetChecksum);
+      for(size_t position = 0; position < Destinations.size(); position++) {
+         const uint32_t destinationID = Destinations.idAt(position);
+         if(markProbed(destinationID)) {
+            sendICMPRequest(Destinations.at(position), destinationID,
+                            FinalMaxTTL, 0, targetChecksum);
+         }
       }
 
       scheduleTimeoutEvent();
@@ -34,6 +34,22 @@
 
 #include "traceroute.h"
 
+#include <list>
+#include <map>
+
+
+// Per-destination detector for RTT level shifts and loss bursts. It is used
+// to trigger an out-of-schedule traceroute.
+struct ChangeDetector
+{
+   double                                MeanRTT        = 0.0;   // Smoothed RTT (us)
+   double                                MeanDeviation  = 0.0;   // Smoothed RTT deviation (us)
+   unsigned int                          Samples        = 0;
+   unsigned int                          ShiftsInRow    = 0;
+   int                                   ShiftDirection = 0;
+   unsigned int                          LostInRow      = 0;
+   std::chrono::steady_clock::time_point LastTrigger;
+};
 
 class Ping : public Traceroute
 {
@@ -50,6 +66,9 @@ class Ping : public Traceroute
    virtual ~Ping();
 
    virtual const std::string& getName() const;
+   virtual void join();
+   void setTracerouteTrigger(Traceroute* traceroute, const unsigned int holdOff);
+   void setSummary(const unsigned int interval, const bool raw);
 
    protected:
    virtual bool prepareRun(const bool newRound = false);
@@ -58,6 +77,28 @@ class Ping : public Traceroute
    virtual bool notReachedWithCurrentTTL();
    virtual void processResults();
    virtual void sendRequests();
+   virtual void initialiseDestinationState(const uint32_t destinationID);
+   void detectChange(const ResultEntry& resultEntry);
+   bool markProbed(const uint32_t destinationID);
+   void removeCompletedDestinations();
+   void addToSummary(const ResultEntry& resultEntry);
+   void writeSummaries(const bool all);
+
+   Traceroute*                               TracerouteTrigger;
+   unsigned int                              TriggerHoldOff;   // Min. seconds between triggers per destination
+   std::vector<ChangeDetector>               ChangeDetectors;  // By destination ID
+   std::vector<bool>                         Probed;           // By destination ID (RemoveDestinationAfterRun)
+
+   unsigned int                              SummaryInterval;  // Seconds (0 for no summaries)
+   bool                                      SummaryRaw;       // Also write the single pings
+   // Summaries by interval start (microseconds since the UTC epoch), then by
+   // destination ID (unused for Probes == 0):
+   std::map<uint64_t, std::vector<PingSummaryRecord>> Summaries;
+   std::list<PingSummaryRecord>              CompletedSummaries; // Of removed destinations
+
+   static const unsigned int                 TriggerWarmUp      = 8;   // Samples before detecting RTT shifts
+   static const unsigned int                 TriggerShiftLength = 3;   // Shifted RTTs in a row for a trigger
+   static const unsigned int                 TriggerLossBurst   = 3;   // Time-outs in a row for a trigger
 
    private:
    static int comparePingResults(const ResultEntry* a, const ResultEntry* b);
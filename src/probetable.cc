@@ -0,0 +1,302 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "probetable.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+const uint32_t ProbeTable::Invalid;
+
+
+// ###### Constructor #######################################################
+ProbeTable::ProbeTable()
+{
+   Capacity       = 0;
+   WindowSize     = 0;
+   Entries        = 0;
+   FirstSeqNumber = 0;
+}
+
+
+// ###### Destructor ########################################################
+ProbeTable::~ProbeTable()
+{
+}
+
+
+// ###### Remove all probes #################################################
+void ProbeTable::clear()
+{
+   for(unsigned int i = 0; i < WindowSize; i++) {
+      DestinationID[position(i)] = Invalid;
+   }
+   WindowSize = 0;
+   Entries    = 0;
+
+   // No probe refers to a reply address anymore:
+   AddressArray.clear();
+   AddressRefs.clear();
+   FreeAddresses.clear();
+   AddressMap.clear();
+}
+
+
+// ###### Add probe #########################################################
+bool ProbeTable::add(const unsigned short                        seqNumber,
+                     const unsigned short                        round,
+                     const unsigned int                          hop,
+                     const uint16_t                              checksum,
+                     const std::chrono::system_clock::time_point sendTime,
+                     const uint32_t                              destinationID)
+{
+   // ====== Drop unused slots at the beginning of the window ===============
+   if(Entries == 0) {
+      clear();
+      FirstSeqNumber = seqNumber;
+      BaseTime       = std::chrono::time_point_cast<std::chrono::microseconds>(sendTime);
+   }
+   else {
+      while( (WindowSize > 0) && (!isUsed(0)) ) {
+         FirstSeqNumber++;
+         WindowSize--;
+      }
+   }
+
+   // ====== Extend window up to the new sequence number ====================
+   // Sequence numbers are increasing. A gap remains from a failed send.
+   const unsigned int offset = (unsigned short)(seqNumber - FirstSeqNumber);
+   if(offset < WindowSize) {
+      return(false);   // Sequence number is already in use!
+   }
+   while(offset >= Capacity) {
+      grow();
+   }
+   for(unsigned int i = WindowSize; i < offset; i++) {
+      DestinationID[position(i)] = Invalid;
+   }
+   WindowSize = offset + 1;
+
+   // ====== Store probe ====================================================
+   long long sendOffset = std::chrono::duration_cast<std::chrono::microseconds>(sendTime - BaseTime).count();
+   if( (sendOffset < 0) || (sendOffset > (long long)0xffffffff) ) {
+      rebase(sendTime);
+      sendOffset = std::chrono::duration_cast<std::chrono::microseconds>(sendTime - BaseTime).count();
+   }
+   const unsigned int p  = position(offset);
+   DestinationID[p]      = destinationID;
+   SendOffset[p]         = (uint32_t)sendOffset;
+   RTT[p]                = 0;
+   Round[p]              = round;
+   Checksum[p]           = checksum;
+   Hop[p]                = (uint8_t)hop;
+   Status[p]             = Unknown;
+   Entries++;
+   return(true);
+}
+
+
+// ###### Find probe by sequence number #####################################
+bool ProbeTable::find(const unsigned short seqNumber, unsigned int& index) const
+{
+   index = (unsigned short)(seqNumber - FirstSeqNumber);
+   return( (index < WindowSize) && (isUsed(index)) );
+}
+
+
+// ###### Set response ######################################################
+void ProbeTable::setResult(const unsigned int                           index,
+                           const std::chrono::system_clock::time_point& receiveTime,
+                           const boost::asio::ip::address&              replyAddress,
+                           const HopStatus                              status)
+{
+   const unsigned int p = position(index);
+   const long long    rtt =
+      std::chrono::duration_cast<std::chrono::microseconds>(receiveTime - sendTime(index)).count();
+   RTT[p] = (uint32_t)std::min(std::max(0LL, rtt), (long long)0xffffffff);
+   if(Status[p] != Unknown) {
+      releaseAddress(ReplyAddress[p]);
+   }
+   if(status != Unknown) {
+      ReplyAddress[p] = acquireAddress(replyAddress);
+   }
+   Status[p] = status;
+}
+
+
+// ###### Remove probe ######################################################
+void ProbeTable::remove(const unsigned int index)
+{
+   const unsigned int p = position(index);
+   if(DestinationID[p] != Invalid) {
+      if(Status[p] != Unknown) {
+         releaseAddress(ReplyAddress[p]);
+      }
+      DestinationID[p] = Invalid;
+      Entries--;
+   }
+}
+
+
+// ###### Materialise probe as ResultEntry ##################################
+ResultEntry ProbeTable::entry(const unsigned int         index,
+                              const DestinationRegistry& destinations) const
+{
+   const unsigned int                          p = position(index);
+   const std::chrono::system_clock::time_point sent = sendTime(index);
+   assert(destinations.isValid(DestinationID[p]));
+   ResultEntry resultEntry(Round[p], (unsigned short)(FirstSeqNumber + index), Hop[p],
+                           Checksum[p], sent,
+                           destinations.at(destinations.positionOf(DestinationID[p])),
+                           DestinationID[p], (HopStatus)Status[p]);
+   if(Status[p] != Unknown) {
+      resultEntry.setReceiveTime(sent + std::chrono::microseconds(RTT[p]));
+      // Just set address, keep traffic class and identifier settings:
+      resultEntry.setDestinationAddress(AddressArray[ReplyAddress[p]]);
+   }
+   return(resultEntry);
+}
+
+
+// ###### Double the number of slots ########################################
+void ProbeTable::grow()
+{
+   const unsigned int oldCapacity = Capacity;
+   Capacity = (Capacity == 0) ? 64 : 2 * Capacity;
+   assert(Capacity <= 65536);
+
+   // ====== Resize columns =================================================
+   // The positions of the slots in the window change with the capacity.
+   // Since the new capacity is a multiple of the old one, a slot either keeps
+   // its position or moves up by the old capacity.
+   DestinationID.resize(Capacity, Invalid);
+   SendOffset.resize(Capacity);
+   RTT.resize(Capacity);
+   ReplyAddress.resize(Capacity);
+   Round.resize(Capacity);
+   Checksum.resize(Capacity);
+   Hop.resize(Capacity);
+   Status.resize(Capacity);
+   if(oldCapacity > 0) {
+      for(unsigned int i = 0; i < WindowSize; i++) {
+         const unsigned int oldPosition = (unsigned short)(FirstSeqNumber + i) & (oldCapacity - 1);
+         const unsigned int newPosition = position(i);
+         if(oldPosition != newPosition) {
+            DestinationID[newPosition] = DestinationID[oldPosition];
+            SendOffset[newPosition]    = SendOffset[oldPosition];
+            RTT[newPosition]           = RTT[oldPosition];
+            ReplyAddress[newPosition]  = ReplyAddress[oldPosition];
+            Round[newPosition]         = Round[oldPosition];
+            Checksum[newPosition]      = Checksum[oldPosition];
+            Hop[newPosition]           = Hop[oldPosition];
+            Status[newPosition]        = Status[oldPosition];
+            DestinationID[oldPosition] = Invalid;
+         }
+      }
+   }
+}
+
+
+// ###### Move base time to oldest outstanding probe ########################
+void ProbeTable::rebase(const std::chrono::system_clock::time_point& sendTime)
+{
+   // ====== Find new base time =============================================
+   std::chrono::system_clock::time_point newBaseTime =
+      std::chrono::time_point_cast<std::chrono::microseconds>(sendTime);
+   for(unsigned int i = 0; i < WindowSize; i++) {
+      if(isUsed(i)) {
+         newBaseTime = std::min(newBaseTime, this->sendTime(i));
+      }
+   }
+
+   // ====== Update send times ==============================================
+   // NOTE: Probes older than 2^32 us (about 71 minutes) than the newest
+   //       one cannot be represented. Their send time is truncated.
+   const long long shift = std::chrono::duration_cast<std::chrono::microseconds>(newBaseTime - BaseTime).count();
+   for(unsigned int i = 0; i < WindowSize; i++) {
+      if(isUsed(i)) {
+         const unsigned int p = position(i);
+         SendOffset[p] = (uint32_t)std::min(std::max(0LL, (long long)SendOffset[p] - shift),
+                                            (long long)0xffffffff);
+      }
+   }
+   const long long newestOffset =
+      std::chrono::duration_cast<std::chrono::microseconds>(sendTime - newBaseTime).count();
+   if(newestOffset > (long long)0xffffffff) {
+      newBaseTime += std::chrono::microseconds(newestOffset - (long long)0xffffffff);
+      for(unsigned int i = 0; i < WindowSize; i++) {
+         if(isUsed(i)) {
+            const unsigned int p = position(i);
+            SendOffset[p] = (uint32_t)std::max(0LL, (long long)SendOffset[p] - (newestOffset - (long long)0xffffffff));
+         }
+      }
+   }
+   BaseTime = newBaseTime;
+}
+
+
+
+// ###### Get pool index of reply address, and reference it ################
+uint32_t ProbeTable::acquireAddress(const boost::asio::ip::address& address)
+{
+   std::map<boost::asio::ip::address, uint32_t>::iterator found = AddressMap.find(address);
+   if(found != AddressMap.end()) {
+      AddressRefs[found->second]++;
+      return(found->second);
+   }
+
+   uint32_t addressIndex;
+   if(!FreeAddresses.empty()) {
+      addressIndex = FreeAddresses.back();
+      FreeAddresses.pop_back();
+      AddressArray[addressIndex] = address;
+   }
+   else {
+      addressIndex = AddressArray.size();
+      AddressArray.push_back(address);
+      AddressRefs.push_back(0);
+   }
+   AddressRefs[addressIndex] = 1;
+   AddressMap.insert(std::pair<boost::asio::ip::address, uint32_t>(address, addressIndex));
+   return(addressIndex);
+}
+
+
+// ###### Release reference to reply address ################################
+void ProbeTable::releaseAddress(const uint32_t addressIndex)
+{
+   assert(AddressRefs[addressIndex] > 0);
+   if(--AddressRefs[addressIndex] == 0) {
+      AddressMap.erase(AddressArray[addressIndex]);
+      FreeAddresses.push_back(addressIndex);
+   }
+}
@@ -0,0 +1,123 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef PROBETABLE_H
+#define PROBETABLE_H
+
+#include "destinationregistry.h"
+#include "resultentry.h"
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+
+// Outstanding probes, stored as columns of small values instead of one
+// ResultEntry object per probe. The slots are a ring indexed by the
+// sequence number, starting at the oldest outstanding probe. Destinations
+// are referred to by their ID in the DestinationRegistry, send times are
+// microseconds relative to a base time. Reply addresses are indexes into a
+// reference-counted pool, since the same few addresses (destinations and
+// routers) reply again and again. ResultEntry objects are only materialised
+// by entry().
+// NOTE: The ID of a destination must remain valid while it has outstanding
+//       probes in the table!
+class ProbeTable
+{
+   public:
+   ProbeTable();
+   ~ProbeTable();
+
+   bool add(const unsigned short                        seqNumber,
+            const unsigned short                        round,
+            const unsigned int                          hop,
+            const uint16_t                              checksum,
+            const std::chrono::system_clock::time_point sendTime,
+            const uint32_t                              destinationID);
+   bool find(const unsigned short seqNumber, unsigned int& index) const;
+   void setResult(const unsigned int                           index,
+                  const std::chrono::system_clock::time_point& receiveTime,
+                  const boost::asio::ip::address&              replyAddress,
+                  const HopStatus                              status);
+   void remove(const unsigned int index);
+   void clear();
+
+   // ====== Access by index (0 to window() - 1) ===========================
+   inline size_t size()                              const { return(Entries);                                      }
+   inline unsigned int window()                      const { return(WindowSize);                                   }
+   inline bool isUsed(const unsigned int index)      const { return(DestinationID[position(index)] != Invalid); }
+   inline unsigned int hop(const unsigned int index) const { return(Hop[position(index)]);                      }
+   inline HopStatus status(const unsigned int index) const { return((HopStatus)Status[position(index)]);        }
+   inline uint32_t destinationID(const unsigned int index) const {
+      return(DestinationID[position(index)]);
+   }
+   inline std::chrono::system_clock::time_point sendTime(const unsigned int index) const {
+      return(BaseTime + std::chrono::microseconds(SendOffset[position(index)]));
+   }
+   ResultEntry entry(const unsigned int index, const DestinationRegistry& destinations) const;
+   // Number of different reply addresses of the probes:
+   inline size_t replyAddresses() const { return(AddressMap.size()); }
+
+   private:
+   inline unsigned int position(const unsigned int index) const {
+      return((unsigned short)(FirstSeqNumber + index) & (Capacity - 1));
+   }
+   void grow();
+   void rebase(const std::chrono::system_clock::time_point& sendTime);
+   uint32_t acquireAddress(const boost::asio::ip::address& address);
+   void releaseAddress(const uint32_t addressIndex);
+
+   static const uint32_t                         Invalid = DestinationRegistry::InvalidID;
+
+   unsigned int                                  Capacity;         // Power of 2, up to 65536
+   unsigned int                                  WindowSize;       // Slots from first outstanding probe
+   size_t                                        Entries;          // Used slots
+   unsigned short                                FirstSeqNumber;
+   std::chrono::system_clock::time_point         BaseTime;         // Full microseconds
+
+   // ====== Columns ========================================================
+   std::vector<uint32_t>                         DestinationID;    // Invalid for unused slot
+   std::vector<uint32_t>                         SendOffset;       // us since BaseTime
+   std::vector<uint32_t>                         RTT;              // us
+   std::vector<uint32_t>                         ReplyAddress;     // Pool index, for Status != Unknown
+   std::vector<uint16_t>                         Round;
+   std::vector<uint16_t>                         Checksum;
+   std::vector<uint8_t>                          Hop;
+   std::vector<uint8_t>                          Status;
+
+   // ====== Reply address pool =============================================
+   std::vector<boost::asio::ip::address>         AddressArray;     // By pool index
+   std::vector<uint32_t>                         AddressRefs;      // By pool index (0 for free)
+   std::vector<uint32_t>                         FreeAddresses;
+   std::map<boost::asio::ip::address, uint32_t>  AddressMap;       // Address -> pool index
+};
+
+#endif
@@ -41,6 +41,7 @@ ResultEntry::ResultEntry(const unsigned short                        round,
                          const uint16_t                              checksum,
                          const std::chrono::system_clock::time_point sendTime,
                          const DestinationInfo&                      destination,
+                         const uint32_t                              destinationID,
                          const HopStatus                             status)
    : Round(round),
      SeqNumber(seqNumber),
@@ -48,6 +49,7 @@ ResultEntry::ResultEntry(const unsigned short                        round,
      Checksum(checksum),
      SendTime(sendTime),
      Destination(destination),
+     DestinationID(destinationID),
      Status(status)
 {
 }
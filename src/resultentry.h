@@ -90,6 +90,7 @@ class ResultEntry {
                const uint16_t                              checksum,
                const std::chrono::system_clock::time_point sendTime,
                const DestinationInfo&                      destination,
+               const uint32_t                              destinationID,
                const HopStatus                             status);
    ~ResultEntry();
 
@@ -97,6 +98,7 @@ class ResultEntry {
    inline unsigned int seqNumber()                            const { return(SeqNumber);              }
    inline unsigned int hop()                                  const { return(Hop);                    }
    const DestinationInfo& destination()                       const { return(Destination);            }
+   inline uint32_t destinationID()                            const { return(DestinationID);          }
    const boost::asio::ip::address& destinationAddress()       const { return(Destination.address());  }
    inline HopStatus status()                                  const { return(Status);                 }
    inline uint16_t checksum()                                 const { return(Checksum);               }
@@ -122,6 +124,7 @@ class ResultEntry {
    const std::chrono::system_clock::time_point SendTime;
 
    DestinationInfo                             Destination;
+   const uint32_t                              DestinationID;    // ID in DestinationRegistry
    HopStatus                                   Status;
    std::chrono::system_clock::time_point       ReceiveTime;
 };
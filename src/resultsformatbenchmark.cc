@@ -0,0 +1,171 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+// Benchmark of the results text formatting: boost::format-based formatting
+// as used before (reference) vs. ResultsFormatter. Both outputs have to be
+// byte-identical.
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "resultsformatter.h"
+
+
+// ###### Reference formatting of Ping result ##############################
+static void referencePing(std::string& output, const PingRecord& record)
+{
+   output += str(boost::format("#P %s %s %x %x %d %d %x")
+                    % record.Source.to_string()
+                    % record.Destination.to_string()
+                    % record.TimeStamp
+                    % record.Checksum
+                    % record.Status
+                    % record.RTT
+                    % (unsigned int)record.TrafficClass);
+   output += "\n";
+}
+
+
+// ###### Reference formatting of Traceroute result ########################
+static void referenceTraceroute(std::string& output, const TracerouteRecord& record)
+{
+   output += str(boost::format("#T %s %s %x %d %x %d %x %x %x")
+                    % record.Source.to_string()
+                    % record.Destination.to_string()
+                    % record.TimeStamp
+                    % record.Round
+                    % record.Checksum
+                    % record.TotalHops
+                    % record.StatusFlags
+                    % record.PathHash
+                    % (unsigned int)record.TrafficClass);
+   output += "\n";
+   for(std::vector<TracerouteHopRecord>::const_iterator iterator = record.Hops.begin();
+       iterator != record.Hops.end(); iterator++) {
+      output += str(boost::format("\t %d %x %d %s")
+                       % iterator->Hop
+                       % iterator->Status
+                       % iterator->RTT
+                       % iterator->Address.to_string());
+      output += "\n";
+   }
+}
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   const unsigned int records = (argc > 1) ? atol(argv[1]) : 200000;
+
+   // ====== Generate results ===============================================
+   std::mt19937_64 random(1);
+   std::vector<boost::asio::ip::address> addresses;
+   for(unsigned int i = 0; i < 64; i++) {
+      addresses.push_back((i % 4 == 0) ?
+         boost::asio::ip::address(boost::asio::ip::make_address_v6("2001:db8:100::" + std::to_string(i))) :
+         boost::asio::ip::address(boost::asio::ip::make_address_v4("10.44." + std::to_string(i) + ".1")));
+   }
+   const boost::asio::ip::address source = boost::asio::ip::make_address("10.1.1.51");
+   std::vector<PingRecord>       pings(records);
+   std::vector<TracerouteRecord> traceroutes(records / 10);
+   uint64_t timeStamp = 1577836800000000ULL;
+   for(std::vector<PingRecord>::iterator iterator = pings.begin(); iterator != pings.end(); iterator++) {
+      iterator->Source       = source;
+      iterator->Destination  = addresses[random() % addresses.size()];
+      iterator->TimeStamp    = (timeStamp += random() % 1000000);
+      iterator->Checksum     = random();
+      iterator->Status       = (random() % 10) ? 255 : 200;
+      iterator->RTT          = random() % 500000;
+      iterator->TrafficClass = (random() % 2) ? 0x00 : 0xb8;
+   }
+   for(std::vector<TracerouteRecord>::iterator iterator = traceroutes.begin(); iterator != traceroutes.end(); iterator++) {
+      iterator->Source       = source;
+      iterator->Destination  = addresses[random() % addresses.size()];
+      iterator->TimeStamp    = (timeStamp += random() % 1000000);
+      iterator->Round        = random() % 3;
+      iterator->Checksum     = random();
+      iterator->TotalHops    = 1 + random() % 20;
+      iterator->StatusFlags  = random() % 0x400;
+      iterator->PathHash     = random();
+      iterator->TrafficClass = 0x00;
+      iterator->Hops.resize(iterator->TotalHops);
+      for(unsigned int h = 0; h < iterator->TotalHops; h++) {
+         iterator->Hops[h].Hop     = h + 1;
+         iterator->Hops[h].Status  = (h + 1 < iterator->TotalHops) ? 1 : 255;
+         iterator->Hops[h].RTT     = random() % 200000;
+         iterator->Hops[h].Address = addresses[random() % addresses.size()];
+      }
+   }
+   size_t lines = pings.size();
+   for(std::vector<TracerouteRecord>::const_iterator iterator = traceroutes.begin(); iterator != traceroutes.end(); iterator++) {
+      lines += 1 + iterator->Hops.size();
+   }
+
+   // ====== Reference formatting ===========================================
+   std::string referenceOutput;
+   std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+   for(std::vector<PingRecord>::const_iterator iterator = pings.begin(); iterator != pings.end(); iterator++) {
+      referencePing(referenceOutput, *iterator);
+   }
+   for(std::vector<TracerouteRecord>::const_iterator iterator = traceroutes.begin(); iterator != traceroutes.end(); iterator++) {
+      referenceTraceroute(referenceOutput, *iterator);
+   }
+   std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+   // ====== ResultsFormatter ===============================================
+   ResultsFormatter formatter;
+   std::string      output;
+   for(std::vector<PingRecord>::const_iterator iterator = pings.begin(); iterator != pings.end(); iterator++) {
+      formatter.formatPing(output, *iterator);
+   }
+   for(std::vector<TracerouteRecord>::const_iterator iterator = traceroutes.begin(); iterator != traceroutes.end(); iterator++) {
+      formatter.formatTraceroute(output, *iterator);
+   }
+   std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+   // ====== Results ========================================================
+   const double referenceTime = std::chrono::duration<double, std::nano>(t2 - t1).count() / lines;
+   const double formatterTime = std::chrono::duration<double, std::nano>(t3 - t2).count() / lines;
+   std::cout << lines << " lines, " << output.size() << " bytes" << std::endl
+             << "boost::format:    " << referenceTime << " ns/line" << std::endl
+             << "ResultsFormatter: " << formatterTime << " ns/line" << std::endl;
+   if(output != referenceOutput) {
+      std::cerr << "ERROR: Outputs differ!" << std::endl;
+      return 1;
+   }
+   std::cout << "Outputs are identical." << std::endl;
+   return 0;
+}
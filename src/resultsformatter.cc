@@ -0,0 +1,366 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "resultsformatter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+
+const size_t AddressTextCache::MaxEntries;
+
+
+// ###### Constructor #######################################################
+AddressTextCache::AddressTextCache()
+{
+}
+
+
+// ###### Destructor ########################################################
+AddressTextCache::~AddressTextCache()
+{
+}
+
+
+// ###### Hash function #####################################################
+size_t AddressTextCache::AddressHash::operator()(const boost::asio::ip::address& address) const
+{
+   if(address.is_v4()) {
+      return(std::hash<uint32_t>()(address.to_v4().to_uint()));
+   }
+   // FNV-1a over the IPv6 address bytes:
+   const boost::asio::ip::address_v6::bytes_type bytes = address.to_v6().to_bytes();
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   for(size_t i = 0; i < bytes.size(); i++) {
+      hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+   }
+   return((size_t)hash);
+}
+
+
+// ###### Get text form of address ##########################################
+const std::string& AddressTextCache::text(const boost::asio::ip::address& address)
+{
+   std::unordered_map<boost::asio::ip::address, std::string, AddressHash>::const_iterator found =
+      Cache.find(address);
+   if(found != Cache.end()) {
+      return(found->second);
+   }
+   if(Cache.size() >= MaxEntries) {
+      Cache.clear();   // Simple bound for very many different addresses
+   }
+   return(Cache.insert(std::make_pair(address, address.to_string())).first->second);
+}
+
+
+
+// ###### Constructor #######################################################
+ResultsFormatter::ResultsFormatter()
+{
+   TimeStampSecond = ~0ULL;
+}
+
+
+// ###### Destructor ########################################################
+ResultsFormatter::~ResultsFormatter()
+{
+}
+
+
+// ###### Append unsigned decimal number ####################################
+void ResultsFormatter::appendUnsigned(std::string& output, uint64_t value)
+{
+   char  buffer[20];
+   char* position = buffer + sizeof(buffer);
+   do {
+      *(--position) = (char)('0' + (value % 10));
+      value /= 10;
+   } while(value != 0);
+   output.append(position, buffer + sizeof(buffer) - position);
+}
+
+
+// ###### Append signed decimal number ######################################
+void ResultsFormatter::appendDecimal(std::string& output, const int64_t value)
+{
+   if(value < 0) {
+      output += '-';
+      appendUnsigned(output, (uint64_t)0 - (uint64_t)value);
+   }
+   else {
+      appendUnsigned(output, (uint64_t)value);
+   }
+}
+
+
+// ###### Append hexadecimal number #########################################
+void ResultsFormatter::appendHex(std::string& output, uint64_t value)
+{
+   static const char digits[] = "0123456789abcdef";
+   char  buffer[16];
+   char* position = buffer + sizeof(buffer);
+   do {
+      *(--position) = digits[value & 0x0f];
+      value >>= 4;
+   } while(value != 0);
+   output.append(position, buffer + sizeof(buffer) - position);
+}
+
+
+// ###### Format Ping result ################################################
+// Format: #P source destination timestamp checksum status rtt trafficClass
+void ResultsFormatter::formatPing(std::string& output, const PingRecord& record)
+{
+   output += "#P ";
+   output += Addresses.text(record.Source);
+   output += ' ';
+   output += Addresses.text(record.Destination);
+   output += ' ';
+   appendHex(output, record.TimeStamp);
+   output += ' ';
+   appendHex(output, record.Checksum);
+   output += ' ';
+   appendUnsigned(output, record.Status);
+   output += ' ';
+   appendDecimal(output, record.RTT);
+   output += ' ';
+   appendHex(output, record.TrafficClass);
+   output += '\n';
+}
+
+
+// ###### Format Ping summary ###############################################
+// Format: #S source destination timestamp interval trafficClass probes lost
+//         minRTT maxRTT sumRTT sumSqRTT p50 p90 p99 sketch
+// The sketch is written as comma-separated bucket:count pairs, or as "-" if
+// there are no RTTs.
+void ResultsFormatter::formatPingSummary(std::string& output, const PingSummaryRecord& record)
+{
+   output += "#S ";
+   output += Addresses.text(record.Source);
+   output += ' ';
+   output += Addresses.text(record.Destination);
+   output += ' ';
+   appendHex(output, record.TimeStamp);
+   output += ' ';
+   appendUnsigned(output, record.Interval);
+   output += ' ';
+   appendHex(output, record.TrafficClass);
+   output += ' ';
+   appendUnsigned(output, record.Probes);
+   output += ' ';
+   appendUnsigned(output, record.Lost);
+   output += ' ';
+   appendDecimal(output, record.MinRTT);
+   output += ' ';
+   appendDecimal(output, record.MaxRTT);
+   output += ' ';
+   appendDecimal(output, record.SumRTT);
+   output += ' ';
+   char sumSq[32];
+   snprintf(sumSq, sizeof(sumSq), "%.0f", record.SumSqRTT);
+   output += sumSq;
+   output += ' ';
+   appendDecimal(output, record.Sketch.quantile(0.50));
+   output += ' ';
+   appendDecimal(output, record.Sketch.quantile(0.90));
+   output += ' ';
+   appendDecimal(output, record.Sketch.quantile(0.99));
+   output += ' ';
+   const std::map<unsigned int, unsigned int>& buckets = record.Sketch.buckets();
+   if(buckets.empty()) {
+      output += '-';
+   }
+   for(std::map<unsigned int, unsigned int>::const_iterator iterator = buckets.begin();
+       iterator != buckets.end(); iterator++) {
+      if(iterator != buckets.begin()) {
+         output += ',';
+      }
+      appendUnsigned(output, iterator->first);
+      output += ':';
+      appendUnsigned(output, iterator->second);
+   }
+   output += '\n';
+}
+
+
+// ###### Format Traceroute header ##########################################
+// Format: #T source destination timestamp round checksum totalHops
+//         statusFlags pathHash trafficClass
+void ResultsFormatter::formatTracerouteHeader(std::string&            output,
+                                              const char*             type,
+                                              const TracerouteRecord& record)
+{
+   output += type;
+   output += Addresses.text(record.Source);
+   output += ' ';
+   output += Addresses.text(record.Destination);
+   output += ' ';
+   appendHex(output, record.TimeStamp);
+   output += ' ';
+   appendUnsigned(output, record.Round);
+   output += ' ';
+   appendHex(output, record.Checksum);
+   output += ' ';
+   appendUnsigned(output, record.TotalHops);
+   output += ' ';
+   appendHex(output, record.StatusFlags);
+   output += ' ';
+   appendHex(output, record.PathHash);
+   output += ' ';
+   appendHex(output, record.TrafficClass);
+}
+
+
+// ###### Format Traceroute result ##########################################
+// Format: #T line, then one line per hop: TAB hop status rtt address
+void ResultsFormatter::formatTraceroute(std::string& output, const TracerouteRecord& record)
+{
+   formatTracerouteHeader(output, "#T ", record);
+   output += '\n';
+   for(std::vector<TracerouteHopRecord>::const_iterator iterator = record.Hops.begin();
+       iterator != record.Hops.end(); iterator++) {
+      output += "\t ";
+      appendUnsigned(output, iterator->Hop);
+      output += ' ';
+      appendHex(output, iterator->Status);
+      output += ' ';
+      appendDecimal(output, iterator->RTT);
+      output += ' ';
+      output += Addresses.text(iterator->Address);
+      output += '\n';
+   }
+}
+
+
+// ###### Format Traceroute result as reference to known path ###############
+// Format: #R line with the header fields of #T, then per hop the RTT
+//         difference, and ":status" if the status has changed
+void ResultsFormatter::formatTracerouteReference(std::string&                            output,
+                                                 const TracerouteRecord&                 record,
+                                                 const std::vector<TracerouteHopRecord>& knownHops)
+{
+   formatTracerouteHeader(output, "#R ", record);
+   for(size_t i = 0; i < knownHops.size(); i++) {
+      output += ' ';
+      appendDecimal(output, record.Hops[i].RTT - knownHops[i].RTT);
+      if(record.Hops[i].Status != knownHops[i].Status) {
+         output += ':';
+         appendHex(output, record.Hops[i].Status);
+      }
+   }
+   output += '\n';
+}
+
+
+// ###### Append time stamp in SQL format ###################################
+// Format: YYYY-MM-DD HH:MM:SS.uuuuuu (UTC). The date and time part is only
+// computed once per second. The year is clamped to 9999, so that the date and
+// time part always has 20 characters.
+void ResultsFormatter::appendTimeStamp(std::string& output, const uint64_t timeStamp)
+{
+   const uint64_t second = std::min(timeStamp / 1000000, (uint64_t)253402300799ULL);   // 9999-12-31 23:59:59
+   if(second != TimeStampSecond) {
+      const time_t t = (time_t)second;
+      struct tm    tm;
+      gmtime_r(&t, &tm);
+      snprintf(TimeStampText, sizeof(TimeStampText), "%04d-%02d-%02d %02d:%02d:%02d.",
+               tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+               tm.tm_hour, tm.tm_min, tm.tm_sec);
+      TimeStampSecond = second;
+   }
+   output.append(TimeStampText, 20);
+   uint32_t microseconds = (uint32_t)(timeStamp % 1000000);
+   char     buffer[6];
+   for(int i = 5; i >= 0; i--) {
+      buffer[i] = (char)('0' + (microseconds % 10));
+      microseconds /= 10;
+   }
+   output.append(buffer, sizeof(buffer));
+}
+
+
+// ###### Format Ping result as PostgreSQL COPY row #########################
+// Columns of table Ping: TimeStamp FromIP ToIP TC Status RTT
+void ResultsFormatter::formatPingCopy(std::string& output, const PingRecord& record)
+{
+   appendTimeStamp(output, record.TimeStamp);
+   output += '\t';
+   output += Addresses.text(record.Source);
+   output += '\t';
+   output += Addresses.text(record.Destination);
+   output += '\t';
+   appendUnsigned(output, record.TrafficClass);
+   output += '\t';
+   appendUnsigned(output, record.Status);
+   output += '\t';
+   appendDecimal(output, record.RTT);
+   output += '\n';
+}
+
+
+// ###### Format Traceroute result as PostgreSQL COPY rows ##################
+// One row per hop. Columns of table Traceroute: TimeStamp FromIP ToIP TC
+// HopNumber TotalHops Status RTT HopIP PathHash Round
+void ResultsFormatter::formatTracerouteCopy(std::string& output, const TracerouteRecord& record)
+{
+   // ====== Columns common to all hops =====================================
+   RowPrefix.clear();
+   appendTimeStamp(RowPrefix, record.TimeStamp);
+   RowPrefix += '\t';
+   RowPrefix += Addresses.text(record.Source);
+   RowPrefix += '\t';
+   RowPrefix += Addresses.text(record.Destination);
+   RowPrefix += '\t';
+   appendUnsigned(RowPrefix, record.TrafficClass);
+   RowPrefix += '\t';
+
+   // ====== Hops ===========================================================
+   for(std::vector<TracerouteHopRecord>::const_iterator iterator = record.Hops.begin();
+       iterator != record.Hops.end(); iterator++) {
+      output += RowPrefix;
+      appendUnsigned(output, iterator->Hop);
+      output += '\t';
+      appendUnsigned(output, record.TotalHops);
+      output += '\t';
+      appendUnsigned(output, iterator->Status | record.StatusFlags);
+      output += '\t';
+      appendDecimal(output, iterator->RTT);
+      output += '\t';
+      output += Addresses.text(iterator->Address);
+      output += '\t';
+      appendDecimal(output, (int64_t)record.PathHash);   // BIGINT is signed
+      output += '\t';
+      appendUnsigned(output, record.Round);
+      output += '\n';
+   }
+}
@@ -0,0 +1,99 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef RESULTSFORMATTER_H
+#define RESULTSFORMATTER_H
+
+#include "resultsrecord.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// ###### Cache of address text forms #######################################
+// Converting an address into text is expensive, while the same few
+// addresses (source, destinations, routers) occur again and again.
+class AddressTextCache
+{
+   public:
+   AddressTextCache();
+   ~AddressTextCache();
+
+   const std::string& text(const boost::asio::ip::address& address);
+   inline void clear() { Cache.clear(); }
+
+   private:
+   struct AddressHash {
+      size_t operator()(const boost::asio::ip::address& address) const;
+   };
+
+   std::unordered_map<boost::asio::ip::address, std::string, AddressHash> Cache;
+
+   static const size_t MaxEntries = 65536;
+};
+
+
+// ###### Text formatting of results ########################################
+// The text is appended to the given buffer, without temporary strings.
+class ResultsFormatter
+{
+   public:
+   ResultsFormatter();
+   ~ResultsFormatter();
+
+   void formatPing(std::string& output, const PingRecord& record);
+   void formatPingSummary(std::string& output, const PingSummaryRecord& record);
+   void formatTraceroute(std::string& output, const TracerouteRecord& record);
+   void formatTracerouteReference(std::string&                            output,
+                                  const TracerouteRecord&                 record,
+                                  const std::vector<TracerouteHopRecord>& knownHops);
+
+   void formatPingCopy(std::string& output, const PingRecord& record);
+   void formatTracerouteCopy(std::string& output, const TracerouteRecord& record);
+
+   static void appendDecimal(std::string& output, const int64_t value);
+   static void appendUnsigned(std::string& output, uint64_t value);
+   static void appendHex(std::string& output, uint64_t value);
+
+   private:
+   void formatTracerouteHeader(std::string&            output,
+                               const char*             type,
+                               const TracerouteRecord& record);
+   void appendTimeStamp(std::string& output, const uint64_t timeStamp);
+
+   AddressTextCache Addresses;
+   std::string      RowPrefix;           // Columns common to all rows
+   uint64_t         TimeStampSecond;     // Second of TimeStampText
+   char             TimeStampText[64];   // "YYYY-MM-DD HH:MM:SS." (space for any int)
+};
+
+#endif
@@ -0,0 +1,235 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "resultsindex.h"
+#include "resultsformatter.h"
+
+#include <algorithm>
+#include <fstream>
+
+
+const unsigned int ResultsIndex::Version;
+const unsigned int ResultsIndex::BloomBitsPerKey;
+const unsigned int ResultsIndex::BloomHashes;
+const unsigned int ResultsIndex::MinBloomBits;
+
+
+// ###### Constructor #######################################################
+ResultsIndex::ResultsIndex()
+{
+   reset();
+}
+
+
+// ###### Reset index for new results file ##################################
+void ResultsIndex::reset()
+{
+   Pings          = 0;
+   Traceroutes    = 0;
+   Hops           = 0;
+   Tuples         = 0;
+   FirstTimeStamp = 0;
+   LastTimeStamp  = 0;
+   KeyHashes.clear();
+   BlockOffsets.clear();
+}
+
+
+// ###### Add Ping result ###################################################
+void ResultsIndex::add(const PingRecord& record)
+{
+   Pings++;
+   addTimeStamp(record.TimeStamp);
+   addAddress(record.Destination);
+}
+
+
+// ###### Add Traceroute result #############################################
+void ResultsIndex::add(const TracerouteRecord& record)
+{
+   Traceroutes++;
+   Hops += record.Hops.size();
+   addTimeStamp(record.TimeStamp);
+   addAddress(record.Destination);
+   addPathHash(record.PathHash);
+}
+
+
+// ###### Add Ping summary #################################################
+// A summary is counted as tuple.
+void ResultsIndex::add(const PingSummaryRecord& record)
+{
+   Tuples++;
+   addTimeStamp(record.TimeStamp);
+   addAddress(record.Destination);
+}
+
+
+// ###### Add tuple #########################################################
+void ResultsIndex::addTuple()
+{
+   Tuples++;
+}
+
+
+// ###### Set block offsets #################################################
+void ResultsIndex::setBlockOffsets(const std::vector<std::pair<uint64_t, uint64_t>>& blockOffsets)
+{
+   BlockOffsets = blockOffsets;
+}
+
+
+// ###### Write index file ##################################################
+bool ResultsIndex::write(const std::string& fileName) const
+{
+   // ====== Make Bloom filter for the number of keys =======================
+   const unsigned int bloomBits =
+      std::max(MinBloomBits,
+               (unsigned int)((BloomBitsPerKey * KeyHashes.size() + 7) & ~(size_t)7));
+   std::vector<unsigned char> bloom(bloomBits / 8, 0x00);
+   for(const uint64_t hash : KeyHashes) {
+      const uint32_t h1 = (uint32_t)hash;
+      const uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+      for(unsigned int i = 0; i < BloomHashes; i++) {
+         const uint32_t bit = (uint32_t)((h1 + (uint64_t)i * h2) % bloomBits);
+         bloom[bit >> 3] |= (unsigned char)(1 << (bit & 7));
+      }
+   }
+
+   std::string output;
+   output.reserve(256 + 2 * bloom.size() + 32 * BlockOffsets.size());
+
+   // ====== Header, counts and time range ==================================
+   output += "#I ";
+   ResultsFormatter::appendUnsigned(output, Version);
+   output += "\nRecords ";
+   ResultsFormatter::appendUnsigned(output, Pings);
+   output += ' ';
+   ResultsFormatter::appendUnsigned(output, Traceroutes);
+   output += ' ';
+   ResultsFormatter::appendUnsigned(output, Hops);
+   output += ' ';
+   ResultsFormatter::appendUnsigned(output, Tuples);
+   output += "\nTime ";
+   ResultsFormatter::appendHex(output, FirstTimeStamp);
+   output += ' ';
+   ResultsFormatter::appendHex(output, LastTimeStamp);
+
+   // ====== Bloom filter ===================================================
+   static const char hexDigits[] = "0123456789abcdef";
+   output += "\nBloom ";
+   ResultsFormatter::appendUnsigned(output, bloomBits);
+   output += ' ';
+   ResultsFormatter::appendUnsigned(output, BloomHashes);
+   output += ' ';
+   for(const unsigned char byte : bloom) {
+      output += hexDigits[byte >> 4];
+      output += hexDigits[byte & 0x0f];
+   }
+   output += '\n';
+
+   // ====== Block offsets ==================================================
+   for(const std::pair<uint64_t, uint64_t>& blockOffset : BlockOffsets) {
+      output += "Block ";
+      ResultsFormatter::appendUnsigned(output, blockOffset.first);
+      output += ' ';
+      ResultsFormatter::appendUnsigned(output, blockOffset.second);
+      output += '\n';
+   }
+
+   std::ofstream indexFile(fileName, std::ios_base::out | std::ios_base::binary);
+   indexFile.write(output.data(), output.size());
+   indexFile.close();
+   return(indexFile.good());
+}
+
+
+// ###### FNV-1a hash (64 bits) #############################################
+uint64_t ResultsIndex::fnv1a(const unsigned char* data, const size_t length)
+{
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   for(size_t i = 0; i < length; i++) {
+      hash ^= data[i];
+      hash *= 0x100000001b3ULL;
+   }
+   return(hash);
+}
+
+
+// ###### Update time range #################################################
+void ResultsIndex::addTimeStamp(const uint64_t timeStamp)
+{
+   if( (FirstTimeStamp == 0) || (timeStamp < FirstTimeStamp) ) {
+      FirstTimeStamp = timeStamp;
+   }
+   if(timeStamp > LastTimeStamp) {
+      LastTimeStamp = timeStamp;
+   }
+}
+
+
+// ###### Add key to Bloom filter ###########################################
+// The hashes are collected, since the filter size depends on the number of
+// keys. It is made by write().
+void ResultsIndex::addKey(const unsigned char* key, const size_t length)
+{
+   KeyHashes.insert(fnv1a(key, length));
+}
+
+
+// ###### Add address to Bloom filter #######################################
+void ResultsIndex::addAddress(const boost::asio::ip::address& address)
+{
+   unsigned char key[17];
+   key[0] = 'D';
+   if(address.is_v4()) {
+      const boost::asio::ip::address_v4::bytes_type bytes = address.to_v4().to_bytes();
+      std::copy(bytes.begin(), bytes.end(), &key[1]);
+      addKey(key, 1 + bytes.size());
+   }
+   else {
+      const boost::asio::ip::address_v6::bytes_type bytes = address.to_v6().to_bytes();
+      std::copy(bytes.begin(), bytes.end(), &key[1]);
+      addKey(key, 1 + bytes.size());
+   }
+}
+
+
+// ###### Add path hash to Bloom filter #####################################
+void ResultsIndex::addPathHash(const uint64_t pathHash)
+{
+   unsigned char key[9];
+   key[0] = 'P';
+   for(unsigned int i = 0; i < 8; i++) {
+      key[1 + i] = (unsigned char)(pathHash >> (8 * i));
+   }
+   addKey(key, sizeof(key));
+}
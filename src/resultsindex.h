@@ -0,0 +1,98 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef RESULTSINDEX_H
+#define RESULTSINDEX_H
+
+#include "resultsrecord.h"
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Sidecar index of a results file (written as "<results file>.idx"), for
+// finding the files relevant for a query without decompressing them:
+//    #I <version>
+//    Records <pings> <traceroutes> <hops> <tuples>
+//    Time <first timestamp> <last timestamp>             (hexadecimal, in us)
+//    Bloom <bits> <hashes> <bitmap>                      (hexadecimal)
+//    Block <uncompressed offset> <compressed offset>     (for each block)
+// The Bloom filter contains the destination addresses ("D" + address bytes)
+// and traceroute path hashes ("P" + hash in little endian). The bit positions
+// of a key are (h1 + i * h2) mod bits, i = 0, ..., hashes - 1, with h1 and h2
+// being the lower and upper 32 bits of the FNV-1a hash of the key (h2 | 1).
+// The filter is sized when writing the index, with BloomBitsPerKey bits per
+// distinct key (at least MinBloomBits).
+// Block offsets are only available for block-parallel compression. A block
+// may start within a record.
+class ResultsIndex
+{
+   public:
+   ResultsIndex();
+
+   void reset();
+   void add(const PingRecord& record);
+   void add(const TracerouteRecord& record);
+   void add(const PingSummaryRecord& record);
+   void addTuple();
+   void setBlockOffsets(const std::vector<std::pair<uint64_t, uint64_t>>& blockOffsets);
+   bool write(const std::string& fileName) const;
+
+   inline unsigned long long getRecords() const {
+      return(Pings + Traceroutes + Tuples);
+   }
+
+   static uint64_t fnv1a(const unsigned char* data, const size_t length);
+
+   static const unsigned int Version         = 1;
+   static const unsigned int BloomBitsPerKey = 10;
+   static const unsigned int BloomHashes     = 7;   // Optimum for 10 bits/key
+   static const unsigned int MinBloomBits    = 64;
+
+   private:
+   void addTimeStamp(const uint64_t timeStamp);
+   void addKey(const unsigned char* key, const size_t length);
+   void addAddress(const boost::asio::ip::address& address);
+   void addPathHash(const uint64_t pathHash);
+
+   unsigned long long                         Pings;
+   unsigned long long                         Traceroutes;
+   unsigned long long                         Hops;
+   unsigned long long                         Tuples;
+   uint64_t                                   FirstTimeStamp;
+   uint64_t                                   LastTimeStamp;
+   std::set<uint64_t>                         KeyHashes;   // For Bloom filter
+   std::vector<std::pair<uint64_t, uint64_t>> BlockOffsets;
+};
+
+#endif
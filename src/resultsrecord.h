@@ -0,0 +1,97 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef RESULTSRECORD_H
+#define RESULTSRECORD_H
+
+#include "rttsketch.h"
+
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+
+// ###### Ping result #######################################################
+struct PingRecord
+{
+   boost::asio::ip::address Source;
+   boost::asio::ip::address Destination;
+   uint64_t                 TimeStamp;      // Send time (microseconds since the UTC epoch)
+   uint16_t                 Checksum;
+   unsigned int             Status;
+   int64_t                  RTT;            // microseconds
+   uint8_t                  TrafficClass;
+};
+
+
+// ###### Ping summary ######################################################
+// Statistics of the pings to a destination within a summary interval:
+struct PingSummaryRecord
+{
+   boost::asio::ip::address Source;
+   boost::asio::ip::address Destination;
+   uint64_t                 TimeStamp;      // Interval start (microseconds since the UTC epoch)
+   unsigned int             Interval;       // seconds
+   uint8_t                  TrafficClass;
+   unsigned int             Probes;
+   unsigned int             Lost;           // Probes without success
+   int64_t                  MinRTT;         // microseconds (-1, if all probes are lost)
+   int64_t                  MaxRTT;         // microseconds (-1, if all probes are lost)
+   int64_t                  SumRTT;         // microseconds
+   double                   SumSqRTT;       // microseconds^2
+   RTTSketch                Sketch;         // RTTs of successful probes
+};
+
+
+// ###### Traceroute result #################################################
+struct TracerouteHopRecord
+{
+   unsigned int             Hop;
+   unsigned int             Status;
+   int64_t                  RTT;            // microseconds
+   boost::asio::ip::address Address;        // Router or destination address
+};
+
+struct TracerouteRecord
+{
+   boost::asio::ip::address         Source;
+   boost::asio::ip::address         Destination;
+   uint64_t                         TimeStamp;   // Send time of first hop (microseconds since the UTC epoch)
+   unsigned int                     Round;
+   uint16_t                         Checksum;
+   unsigned int                     TotalHops;
+   unsigned int                     StatusFlags;
+   uint64_t                         PathHash;
+   uint8_t                          TrafficClass;
+   std::vector<TracerouteHopRecord> Hops;
+};
+
+#endif
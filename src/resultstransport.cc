@@ -0,0 +1,436 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "resultstransport.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/crc.hpp>
+
+
+const size_t       ResultsTransport::MaxQueuedBytes;
+const unsigned int ResultsTransport::ConnectTimeout;
+const unsigned int ResultsTransport::TransferTimeout;
+const unsigned int ResultsTransport::RetryInterval;
+
+
+// ###### Constructor #######################################################
+ResultsTransport::ResultsTransport(const std::string& collectorAddress,
+                                   const std::string& spoolDirectory,
+                                   const uid_t        uid,
+                                   const gid_t        gid)
+   : CollectorAddress(collectorAddress),
+     SpoolDirectory(spoolDirectory),
+     UID(uid),
+     GID(gid),
+     Socket(IOService)
+{
+   Connected     = false;
+   QueuedBytes   = 0;
+   Spooled       = false;
+   StopRequested = false;
+}
+
+
+// ###### Destructor ########################################################
+// Queued batches are still sent. If this fails, they are spooled.
+ResultsTransport::~ResultsTransport()
+{
+   if(Thread.joinable()) {
+      {
+         std::lock_guard<std::mutex> lock(QueueMutex);
+         StopRequested = true;
+         QueueCondition.notify_one();
+      }
+      Thread.join();
+   }
+   disconnect();
+}
+
+
+// ###### Prepare spool directory and start transport thread ################
+bool ResultsTransport::start()
+{
+   std::vector<boost::asio::generic::stream_protocol::endpoint> endpoints;
+   if(!resolveAddress(CollectorAddress, endpoints)) {
+      HPCT_LOG(error) << "Bad collector address " << CollectorAddress;
+      return(false);
+   }
+   try {
+      const boost::filesystem::path tempDirectory = SpoolDirectory / "tmp";
+      boost::filesystem::create_directories(tempDirectory);
+      const int r1 = chown(SpoolDirectory.string().c_str(), UID, GID);
+      const int r2 = chown(tempDirectory.string().c_str(), UID, GID);
+      if(r1 || r2) {
+         HPCT_LOG(warning) << "Setting ownership of " << SpoolDirectory << " and " << tempDirectory
+                           << " to UID " << UID << ", GID " << GID << " failed: " << strerror(errno);
+      }
+   }
+   catch(std::exception const& e) {
+      HPCT_LOG(error) << "Unable to prepare spool directory - " << e.what();
+      return(false);
+   }
+   Thread = std::thread(&ResultsTransport::run, this);
+   return(true);
+}
+
+
+// ###### Send batch ########################################################
+// The content is moved into the queue.
+void ResultsTransport::send(const std::string& name, std::string&& content)
+{
+   std::unique_lock<std::mutex> lock(QueueMutex);
+   if(QueuedBytes + content.size() > MaxQueuedBytes) {
+      // The collector is too slow or unreachable -> spool the batch:
+      lock.unlock();
+      const Batch batch = { name, std::move(content) };
+      if(spill(batch)) {
+         lock.lock();
+         Spooled = true;
+         QueueCondition.notify_one();
+      }
+      return;
+   }
+   QueuedBytes += content.size();
+   Queue.push_back(Batch { name, std::move(content) });
+   QueueCondition.notify_one();
+}
+
+
+// ###### Transport thread ##################################################
+void ResultsTransport::run()
+{
+   std::unique_lock<std::mutex> lock(QueueMutex);
+   while(true) {
+      // ====== Connect, and send spooled batches first =====================
+      if( (!Connected) || (Spooled) ) {
+         Spooled = false;
+         bool success = false;
+         if(!StopRequested) {
+            lock.unlock();
+            success = ((Connected) || (connect())) && (replaySpool());
+            lock.lock();
+         }
+         if(!success) {
+            disconnect();
+            // ====== Spool queued batches, and retry later =================
+            while(!Queue.empty()) {
+               spill(Queue.front());
+               QueuedBytes -= Queue.front().Content.size();
+               Queue.pop_front();
+            }
+            if(StopRequested) {
+               break;
+            }
+            QueueCondition.wait_for(lock, std::chrono::milliseconds(RetryInterval),
+                                    [this]() { return(StopRequested); });
+            continue;
+         }
+      }
+
+      // ====== Send queued batch ===========================================
+      if(!Queue.empty()) {
+         const Batch batch = std::move(Queue.front());
+         QueuedBytes -= batch.Content.size();
+         Queue.pop_front();
+         lock.unlock();
+         if(!transmit(batch)) {
+            disconnect();
+            spill(batch);
+         }
+         lock.lock();
+         continue;
+      }
+
+      // ====== Wait for new batches ========================================
+      if(StopRequested) {
+         break;
+      }
+      QueueCondition.wait(lock, [this]() {
+         return( (StopRequested) || (Spooled) || (!Queue.empty()) );
+      });
+   }
+}
+
+
+// ###### Connect to collector ##############################################
+bool ResultsTransport::connect()
+{
+   std::vector<boost::asio::generic::stream_protocol::endpoint> endpoints;
+   if(!resolveAddress(CollectorAddress, endpoints)) {
+      HPCT_LOG(warning) << "Unable to resolve collector address " << CollectorAddress;
+      return(false);
+   }
+   for(const boost::asio::generic::stream_protocol::endpoint& endpoint : endpoints) {
+      bool                      completed = false;
+      boost::system::error_code errorCode;
+      Socket.async_connect(endpoint, [&](const boost::system::error_code& error) {
+         errorCode = error;
+         completed = true;
+      });
+      if( (waitForCompletion(completed, ConnectTimeout)) && (!errorCode) ) {
+         HPCT_LOG(info) << "Connected to collector " << CollectorAddress;
+         Connected = true;
+         return(true);
+      }
+      disconnect();
+   }
+   HPCT_LOG(warning) << "Unable to connect to collector " << CollectorAddress
+                     << " -> spooling results in " << SpoolDirectory;
+   return(false);
+}
+
+
+// ###### Disconnect from collector #########################################
+void ResultsTransport::disconnect()
+{
+   boost::system::error_code errorCode;
+   Socket.close(errorCode);
+   Connected = false;
+}
+
+
+// ###### Send batch and wait for its acknowledgement #######################
+bool ResultsTransport::transmit(const Batch& batch)
+{
+   // ====== Send batch =====================================================
+   char header[CollectorBatchHeaderSize];
+   header[0] = CMT_Batch;
+   header[1] = 0x00;
+   putUInt16(&header[2], (uint16_t)batch.Name.size());
+   putUInt32(&header[4], (uint32_t)batch.Content.size());
+   putUInt32(&header[8], computeCRC32(batch.Content));
+   const std::vector<boost::asio::const_buffer> buffers = {
+      boost::asio::buffer(header, sizeof(header)),
+      boost::asio::buffer(batch.Name),
+      boost::asio::buffer(batch.Content)
+   };
+   bool                      completed = false;
+   boost::system::error_code errorCode;
+   boost::asio::async_write(Socket, buffers,
+                            [&](const boost::system::error_code& error, std::size_t) {
+      errorCode = error;
+      completed = true;
+   });
+   if( (!waitForCompletion(completed, TransferTimeout)) || (errorCode) ) {
+      HPCT_LOG(warning) << "Sending batch " << batch.Name << " to collector failed";
+      return(false);
+   }
+
+   // ====== Wait for acknowledgement =======================================
+   char acknowledge[CollectorAcknowledgeHeaderSize + CollectorMaxNameLength];
+   completed = false;
+   boost::asio::async_read(Socket,
+                           boost::asio::buffer(acknowledge, CollectorAcknowledgeHeaderSize + batch.Name.size()),
+                           [&](const boost::system::error_code& error, std::size_t) {
+      errorCode = error;
+      completed = true;
+   });
+   if( (!waitForCompletion(completed, TransferTimeout)) || (errorCode) ) {
+      HPCT_LOG(warning) << "No acknowledgement of batch " << batch.Name << " from collector";
+      return(false);
+   }
+   if( (acknowledge[0] != CMT_Acknowledge) ||
+       (getUInt16(&acknowledge[2]) != batch.Name.size()) ||
+       (batch.Name.compare(0, std::string::npos, &acknowledge[CollectorAcknowledgeHeaderSize], batch.Name.size()) != 0) ) {
+      HPCT_LOG(warning) << "Bad acknowledgement of batch " << batch.Name << " from collector";
+      return(false);
+   }
+   switch(acknowledge[1]) {
+      case CAS_Stored:
+         HPCT_LOG(trace) << "Batch " << batch.Name << " has been stored by collector";
+       break;
+      case CAS_Duplicate:
+         HPCT_LOG(debug) << "Batch " << batch.Name << " had already been stored by collector";
+       break;
+      default:
+         HPCT_LOG(warning) << "Batch " << batch.Name << " has been rejected by collector";
+         return(false);
+       break;
+   }
+   return(true);
+}
+
+
+// ###### Run I/O until completion or timeout ###############################
+// On timeout, the socket is closed, i.e. the operation is cancelled.
+bool ResultsTransport::waitForCompletion(const bool& completed, const unsigned int timeout)
+{
+   IOService.restart();
+   IOService.run_for(std::chrono::milliseconds(timeout));
+   if(!completed) {
+      boost::system::error_code errorCode;
+      Socket.close(errorCode);
+      IOService.restart();
+      IOService.run();
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Write batch into spool directory ##################################
+bool ResultsTransport::spill(const Batch& batch)
+{
+   const boost::filesystem::path tempFileName   = SpoolDirectory / "tmp" / batch.Name;
+   const boost::filesystem::path targetFileName = SpoolDirectory / batch.Name;
+   try {
+      std::ofstream spoolFile(tempFileName.string(), std::ios_base::out | std::ios_base::binary);
+      spoolFile.write(batch.Content.data(), batch.Content.size());
+      spoolFile.close();
+      if(!spoolFile.good()) {
+         throw std::runtime_error("Unable to write " + tempFileName.string());
+      }
+      if(chown(tempFileName.c_str(), UID, GID) != 0) {
+         HPCT_LOG(warning) << "Setting ownership of " << tempFileName
+                           << " to UID " << UID << ", GID " << GID
+                           << " failed: " << strerror(errno);
+      }
+      boost::filesystem::rename(tempFileName, targetFileName);
+   }
+   catch(std::exception const& e) {
+      HPCT_LOG(error) << "Unable to spool batch " << batch.Name << " - " << e.what();
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Send spooled batches ##############################################
+bool ResultsTransport::replaySpool()
+{
+   // ====== Get spooled batches, in order of their sequence numbers ========
+   std::vector<std::string> names;
+   try {
+      for(const boost::filesystem::directory_entry& entry :
+          boost::filesystem::directory_iterator(SpoolDirectory)) {
+         if(boost::filesystem::is_regular_file(entry.status())) {
+            names.push_back(entry.path().filename().string());
+         }
+      }
+   }
+   catch(std::exception const& e) {
+      HPCT_LOG(error) << "Unable to read spool directory - " << e.what();
+      return(false);
+   }
+   std::sort(names.begin(), names.end());
+
+   // ====== Send spooled batches ===========================================
+   for(const std::string& name : names) {
+      const boost::filesystem::path fileName = SpoolDirectory / name;
+      std::ifstream spoolFile(fileName.string(), std::ios_base::in | std::ios_base::binary);
+      const Batch   batch = {
+         name,
+         std::string((std::istreambuf_iterator<char>(spoolFile)),
+                     std::istreambuf_iterator<char>())
+      };
+      if( (!spoolFile.good() && !spoolFile.eof()) || (!isValidName(name)) ) {
+         HPCT_LOG(error) << "Unable to read spooled batch " << fileName;
+         continue;
+      }
+      if(!transmit(batch)) {
+         return(false);
+      }
+      boost::system::error_code errorCode;
+      boost::filesystem::remove(fileName, errorCode);
+   }
+   if(!names.empty()) {
+      HPCT_LOG(info) << "Sent " << names.size() << " spooled batches to collector";
+   }
+   return(true);
+}
+
+
+// ###### Resolve collector address #########################################
+// The address is either "unix:/path" or "host:port", with an IPv6 address
+// in brackets.
+bool ResultsTransport::resolveAddress(const std::string&                                            address,
+                                      std::vector<boost::asio::generic::stream_protocol::endpoint>& endpoints)
+{
+   endpoints.clear();
+   if(address.compare(0, 5, "unix:") == 0) {
+      if(address.size() <= 5) {
+         return(false);
+      }
+      endpoints.push_back(boost::asio::local::stream_protocol::endpoint(address.substr(5)));
+      return(true);
+   }
+
+   const size_t colon = address.rfind(':');
+   if( (colon == std::string::npos) || (colon == 0) || (colon + 1 == address.size()) ) {
+      return(false);
+   }
+   std::string host = address.substr(0, colon);
+   if( (host.size() >= 2) && (host.front() == '[') && (host.back() == ']') ) {
+      host = host.substr(1, host.size() - 2);
+   }
+   boost::asio::io_service        ioService;
+   boost::asio::ip::tcp::resolver resolver(ioService);
+   boost::system::error_code      errorCode;
+   const boost::asio::ip::tcp::resolver::results_type results =
+      resolver.resolve(host, address.substr(colon + 1), errorCode);
+   if(errorCode) {
+      return(false);
+   }
+   for(const boost::asio::ip::tcp::resolver::results_type::value_type& entry : results) {
+      endpoints.push_back(entry.endpoint());
+   }
+   return(!endpoints.empty());
+}
+
+
+// ###### Check batch name ##################################################
+// The name is used as file name, i.e. it must not contain a path.
+bool ResultsTransport::isValidName(const std::string& name)
+{
+   return( (!name.empty()) && (name.size() <= CollectorMaxNameLength) &&
+           (name[0] != '.') && (name.find('/') == std::string::npos) &&
+           (name.find('\0') == std::string::npos) );
+}
+
+
+// ###### Compute CRC-32 of batch content ###################################
+uint32_t ResultsTransport::computeCRC32(const std::string& content)
+{
+   boost::crc_32_type crc;
+   crc.process_bytes(content.data(), content.size());
+   return(crc.checksum());
+}
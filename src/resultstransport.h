@@ -0,0 +1,149 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef RESULTSTRANSPORT_H
+#define RESULTSTRANSPORT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/filesystem.hpp>
+
+
+// ====== Collector protocol ================================================
+// All integers are in network byte order.
+// Batch:       Type 'B' (u8), Flags (u8), NameLength (u16),
+//              ContentLength (u32), CRC-32 of Content (u32), Name, Content
+// Acknowledge: Type 'A' (u8), Status (u8), NameLength (u16), Name
+// A batch is the complete (compressed) contents of one results file, and its
+// name is the results file name. The collector stores the batch under this
+// name, before acknowledging it. Since the name is unique, a batch sent again
+// (e.g. after a lost acknowledgement) is recognised as duplicate.
+enum CollectorMessageType {
+   CMT_Batch       = 'B',
+   CMT_Acknowledge = 'A'
+};
+
+enum CollectorAcknowledgeStatus {
+   CAS_Stored    = 0,
+   CAS_Duplicate = 1,
+   CAS_Rejected  = 2
+};
+
+const size_t CollectorBatchHeaderSize       = 12;
+const size_t CollectorAcknowledgeHeaderSize = 4;
+const size_t CollectorMaxNameLength         = 255;
+const size_t CollectorMaxContentLength      = 256 << 20;
+
+
+// Sends results batches to a collector, via TCP ("host:port") or a Unix
+// socket ("unix:/path"). While the collector is unreachable, batches are
+// spooled to disk, and sent after reconnecting. A batch is removed only after
+// the collector has acknowledged it. The transport is shared by all results
+// writers.
+class ResultsTransport
+{
+   public:
+   ResultsTransport(const std::string& collectorAddress,
+                    const std::string& spoolDirectory,
+                    const uid_t        uid,
+                    const gid_t        gid);
+   ~ResultsTransport();
+
+   bool start();
+   void send(const std::string& name, std::string&& content);
+
+   static bool resolveAddress(const std::string&                                            address,
+                              std::vector<boost::asio::generic::stream_protocol::endpoint>& endpoints);
+   static bool isValidName(const std::string& name);
+   static uint32_t computeCRC32(const std::string& content);
+
+   // ====== Integers in network byte order =================================
+   static inline void putUInt16(char* buffer, const uint16_t value) {
+      buffer[0] = (char)(value >> 8);
+      buffer[1] = (char)value;
+   }
+   static inline void putUInt32(char* buffer, const uint32_t value) {
+      putUInt16(buffer, (uint16_t)(value >> 16));
+      putUInt16(buffer + 2, (uint16_t)value);
+   }
+   static inline uint16_t getUInt16(const char* buffer) {
+      return(((uint16_t)(unsigned char)buffer[0] << 8) | (uint16_t)(unsigned char)buffer[1]);
+   }
+   static inline uint32_t getUInt32(const char* buffer) {
+      return(((uint32_t)getUInt16(buffer) << 16) | (uint32_t)getUInt16(buffer + 2));
+   }
+
+   private:
+   struct Batch {
+      std::string Name;
+      std::string Content;
+   };
+
+   void run();
+   bool connect();
+   void disconnect();
+   bool transmit(const Batch& batch);
+   bool waitForCompletion(const bool& completed, const unsigned int timeout);
+   bool spill(const Batch& batch);
+   bool replaySpool();
+
+   const std::string                             CollectorAddress;
+   const boost::filesystem::path                 SpoolDirectory;
+   const uid_t                                   UID;
+   const gid_t                                   GID;
+
+   boost::asio::io_service                       IOService;
+   boost::asio::generic::stream_protocol::socket Socket;
+   bool                                          Connected;
+   std::thread                                   Thread;
+
+   std::mutex                                    QueueMutex;
+   std::condition_variable                       QueueCondition;
+   std::deque<Batch>                             Queue;
+   size_t                                        QueuedBytes;
+   bool                                          Spooled;          // Spooled while connected
+   bool                                          StopRequested;
+
+   static const size_t                           MaxQueuedBytes  = 64 << 20;
+   static const unsigned int                     ConnectTimeout  = 5000;    // ms
+   static const unsigned int                     TransferTimeout = 30000;   // ms
+   static const unsigned int                     RetryInterval   = 5000;    // ms
+};
+
+#endif
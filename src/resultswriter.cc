@@ -31,11 +31,15 @@
 
 #include "resultswriter.h"
 #include "logger.h"
+#include "parallelcompressor.h"
+#include "zstdcompressor.h"
 
+#include <algorithm>
 #include <unistd.h>
 
 #include <boost/format.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -43,6 +47,14 @@
 // #include <boost/process/environment.hpp>
 
 
+size_t             ResultsWriter::LogSegmentSize = 0;
+ResultsTransport*  ResultsWriter::Transport      = nullptr;
+bool               ResultsWriter::WriteIndex     = false;
+const unsigned int ResultsWriter::MaxBlockingTime;
+const unsigned int ResultsWriter::CollectorBatchInterval;
+const unsigned int ResultsWriter::WriterWakeUp;
+
+
 // ###### Constructor #######################################################
 ResultsWriter::ResultsWriter(const std::string&            directory,
                              const std::string&            uniqueID,
@@ -50,23 +62,59 @@ ResultsWriter::ResultsWriter(const std::string&            directory,
                              const unsigned int            transactionLength,
                              const uid_t                   uid,
                              const gid_t                   gid,
-                             const ResultsWriterCompressor compressor)
+                             const ResultsWriterCompressor compressor,
+                             const ResultsWriterFormat     format,
+                             const size_t                  queueLength,
+                             const bool                    shared)
    : Directory(directory),
      UniqueID(uniqueID),
      FormatName(formatName),
      TransactionLength(transactionLength),
      UID(uid),
      GID(gid),
-     Compressor(compressor)
+     Compressor(compressor),
+     Format(format),
+     Shared(shared)
 {
-   Inserts   = 0;
-   SeqNumber = 0;
+   Inserts         = 0;
+   SeqNumber       = 0;
+   QueueHead.store(0);
+   QueueTail.store(0);
+   WriterWaiting.store(false);
+   InserterWaiting.store(false);
+   StopWriter.store(false);
+   Dropped.store(0);
+   Blocked.store(0);
+   ReportedDropped = 0;
+   InsertBlocked   = false;
+   InsertTimedOut  = false;
+   if(queueLength > 0) {
+      size_t queueSize = 1;
+      while(queueSize < queueLength) {
+         queueSize <<= 1;
+      }
+      Queue.resize(queueSize);
+   }
 }
 
 
 // ###### Destructor ########################################################
 ResultsWriter::~ResultsWriter()
 {
+   // ====== Stop writer thread, after writing the queued results ===========
+   if(WriterThread.joinable()) {
+      StopWriter.store(true);
+      {
+         std::lock_guard<std::mutex> lock(WakeMutex);
+         WakeCondition.notify_one();
+      }
+      WriterThread.join();
+   }
+   if(Dropped.load() > 0) {
+      HPCT_LOG(warning) << "Results writer " << UniqueID << " has dropped "
+                        << Dropped.load() << " results due to full queue";
+   }
+
    changeFile(false);
 }
 
@@ -89,15 +137,44 @@ bool ResultsWriter::prepare()
       HPCT_LOG(error) << "Unable to prepare directories - " << e.what();
       return(false);
    }
-   return(changeFile());
+   if(changeFile() == false) {
+      return(false);
+   }
+
+   // ====== Start writer thread ============================================
+   if(!Queue.empty()) {
+      WriterThread = std::thread(&ResultsWriter::runWriterThread, this);
+   }
+   return(true);
 }
 
 
 // ###### Change output file ################################################
 bool ResultsWriter::changeFile(const bool createNewFile)
 {
+   // ====== Close current append log segment ==============================
+   if(Log.isOpen()) {
+      Log.close();
+      if(Inserts == 0) {
+         // empty segment -> just remove it!
+         boost::system::error_code errorCode;
+         boost::filesystem::remove(TargetFileName, errorCode);
+      }
+   }
+
+   // ====== Close current batch, and send it to the collector ==============
+   else if(Transport != nullptr) {
+      if(!OutputStream.empty()) {
+         OutputStream.reset();
+         if(Inserts > 0) {
+            Transport->send(TargetFileName.filename().string(), std::move(Batch));
+         }
+         Batch.clear();
+      }
+   }
+
    // ====== Close current file =============================================
-   if(OutputFile.is_open()) {
+   else if(OutputFile.is_open()) {
       OutputStream.reset();
       OutputFile.close();
       try {
@@ -106,7 +183,10 @@ bool ResultsWriter::changeFile(const bool createNewFile)
             boost::filesystem::remove(TempFileName);
          }
          else {
-            // file has contents -> move it!
+            // file has contents -> move it (after its sidecar index)!
+            if(WriteIndex) {
+               writeIndex();
+            }
             boost::filesystem::rename(TempFileName, TargetFileName);
          }
       }
@@ -116,9 +196,24 @@ bool ResultsWriter::changeFile(const bool createNewFile)
    }
 
    // ====== Create new file ================================================
+   // The path dictionary is per file, since each file is imported on its own.
+   PathDictionary.clear();
+   BinaryEncoder.reset();
+   Index.reset();
+   BlockCompressor.reset();
    Inserts = 0;
    SeqNumber++;
-   if(createNewFile) {
+   if( (createNewFile) && (LogSegmentSize > 0) ) {
+      // ====== Create new append log segment ===============================
+      // The segment is visible in the results directory while being written.
+      const std::string name = UniqueID + str(boost::format("-%09d.hpctlog") % SeqNumber);
+      TempFileName       = Directory / "tmp" / name;
+      TargetFileName     = Directory / name;
+      OutputCreationTime = std::chrono::steady_clock::now();
+      return(Log.create(TempFileName.string(), TargetFileName.string(), LogSegmentSize,
+                        (Format == Binary) ? ALCT_Binary : ALCT_Text, UID, GID));
+   }
+   else if(createNewFile) {
       try {
          const char* extension = "";
          switch(Compressor) {
@@ -133,13 +228,22 @@ bool ResultsWriter::changeFile(const bool createNewFile)
             case GZip:
                extension = ".gz";
              break;
+            case ZStd:
+               extension = ".zst";
+             break;
             default:
              break;
          }
-         const std::string name = UniqueID + str(boost::format("-%09d.results%s") % SeqNumber % extension);
+         const std::string name = UniqueID + str(boost::format("-%09d.%s%s")
+                                                    % SeqNumber
+                                                    % ((Format == Binary) ? "hpct" :
+                                                          ((Format == PostgreSQLCopy) ? "pgcopy" : "results"))
+                                                    % extension);
          TempFileName   = Directory / "tmp" / name;
          TargetFileName = Directory / name;
-         OutputFile.open(TempFileName.c_str(), std::ios_base::out | std::ios_base::binary);
+         if(Transport == nullptr) {
+            OutputFile.open(TempFileName.c_str(), std::ios_base::out | std::ios_base::binary);
+         }
          switch(Compressor) {
             /*
             case XZ:
@@ -147,17 +251,44 @@ bool ResultsWriter::changeFile(const bool createNewFile)
              break;
             */
             case BZip2:
-               OutputStream.push(boost::iostreams::bzip2_compressor());
+               if(ParallelCompressor::getWorkers() > 0) {
+                  BlockCompressor.reset(new ParallelCompressor(ParallelCompressor::BZip2Blocks));
+                  OutputStream.push(*BlockCompressor);
+               }
+               else {
+                  OutputStream.push(boost::iostreams::bzip2_compressor());
+               }
              break;
             case GZip:
-               OutputStream.push(boost::iostreams::gzip_compressor());
+               if(ParallelCompressor::getWorkers() > 0) {
+                  BlockCompressor.reset(new ParallelCompressor(ParallelCompressor::GZipBlocks));
+                  OutputStream.push(*BlockCompressor);
+               }
+               else {
+                  OutputStream.push(boost::iostreams::gzip_compressor());
+               }
              break;
+            case ZStd:
+#ifdef HAVE_ZSTD
+               OutputStream.push(ZstdCompressor());
+             break;
+#else
+               // Never write uncompressed data into a .zst file:
+               HPCT_LOG(error) << "Zstandard compression is not supported by this build";
+               return(false);
+#endif
             default:
              break;
          }
-         OutputStream.push(OutputFile);
+         if(Transport != nullptr) {
+            OutputStream.push(boost::iostreams::back_inserter(Batch));
+         }
+         else {
+            OutputStream.push(OutputFile);
+         }
          OutputCreationTime = std::chrono::steady_clock::now();
-         if( (OutputStream.good()) && (chown(TempFileName.c_str(), UID, GID) != 0) ) {
+         if( (Transport == nullptr) && (OutputStream.good()) &&
+             (chown(TempFileName.c_str(), UID, GID) != 0) ) {
             HPCT_LOG(warning) << "Setting ownership of " << TempFileName
                               << " to UID " << UID << ", GID " << GID
                               << " failed: " << strerror(errno);
@@ -173,22 +304,517 @@ bool ResultsWriter::changeFile(const bool createNewFile)
 }
 
 
+// ###### Configure Zstandard compression ###################################
+bool ResultsWriter::configureZstd(const int          level,
+                                  const unsigned int workers,
+                                  const std::string& dictionaryFileName)
+{
+#ifdef HAVE_ZSTD
+   return(ZstdCompressor::configure(level, workers, dictionaryFileName));
+#else
+   (void)level;
+   (void)workers;
+   (void)dictionaryFileName;
+   HPCT_LOG(error) << "Zstandard compression is not supported by this build";
+   return(false);
+#endif
+}
+
+
+// ###### Configure append log segments instead of results files ##########
+// NOTE: This has to be called before creating any results writer!
+bool ResultsWriter::configureAppendLog(const size_t segmentSize)
+{
+   LogSegmentSize = segmentSize;
+   return(true);
+}
+
+
+// ###### Configure transport to collector instead of results files #######
+// NOTE: This has to be called before creating any results writer!
+bool ResultsWriter::configureCollector(const std::string& collectorAddress,
+                                       const std::string& spoolDirectory,
+                                       const uid_t        uid,
+                                       const gid_t        gid)
+{
+   closeCollector();
+   Transport = new ResultsTransport(collectorAddress, spoolDirectory, uid, gid);
+   if(!Transport->start()) {
+      closeCollector();
+      return(false);
+   }
+   return(true);
+}
+
+
+// ###### Send outstanding batches, and close transport to collector #######
+// NOTE: This has to be called after deleting all results writers!
+void ResultsWriter::closeCollector()
+{
+   if(Transport != nullptr) {
+      delete Transport;
+      Transport = nullptr;
+   }
+}
+
+
+// ###### Configure writing of sidecar index files #########################
+bool ResultsWriter::configureIndex(const bool writeIndex)
+{
+   WriteIndex = writeIndex;
+   return(true);
+}
+
+
+// ###### Configure block-parallel BZip2/GZip compression ##################
+bool ResultsWriter::configureParallelCompression(const unsigned int workers)
+{
+   return(ParallelCompressor::configure(workers));
+}
+
+
 // ###### Start new transaction, if transaction length has been reached #####
 bool ResultsWriter::mayStartNewTransaction()
 {
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   if(!Queue.empty()) {
+      // The writer thread takes care of the transactions. Just report drops:
+      const unsigned long long dropped = Dropped.load();
+      if(dropped != ReportedDropped) {
+         HPCT_LOG(warning) << "Results queue of " << UniqueID << " is full, dropped "
+                           << (dropped - ReportedDropped) << " results";
+         ReportedDropped = dropped;
+      }
+      return(true);
+   }
+   return(checkTransactionLength());
+}
+
+
+// ###### Change output file, if transaction length has been reached ########
+// With a collector, a batch is sent at least every CollectorBatchInterval,
+// i.e. the transaction length does not set the latency.
+bool ResultsWriter::checkTransactionLength()
+{
+   const unsigned int length = (Transport != nullptr) ?
+                                  std::min(TransactionLength, CollectorBatchInterval) :
+                                  TransactionLength;
    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-   if(std::chrono::duration_cast<std::chrono::seconds>(now - OutputCreationTime).count() > TransactionLength) {
+   if(std::chrono::duration_cast<std::chrono::seconds>(now - OutputCreationTime).count() > length) {
       return(changeFile());
    }
    return(true);
 }
 
 
-// ###### Generate INSERT statement #########################################
+// ###### Insert tuple ######################################################
 void ResultsWriter::insert(const std::string& tuple)
 {
-   OutputStream << tuple << std::endl;
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   enqueue(tuple);
+}
+
+
+// ###### Insert Ping result ################################################
+void ResultsWriter::insert(const PingRecord& record)
+{
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   enqueue(record);
+}
+
+
+// ###### Insert Traceroute result ##########################################
+void ResultsWriter::insert(const TracerouteRecord& record)
+{
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   enqueue(record);
+}
+
+
+// ###### Insert batch of Ping results ######################################
+// The batch is inserted under one lock, i.e. it is not interleaved with
+// results of other services sharing this writer.
+void ResultsWriter::insert(const std::vector<PingRecord>& records)
+{
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   for(std::vector<PingRecord>::const_iterator iterator = records.begin();
+       iterator != records.end(); iterator++) {
+      enqueue(*iterator);
+   }
+}
+
+
+// ###### Insert batch of Traceroute results ################################
+void ResultsWriter::insert(const std::vector<TracerouteRecord>& records)
+{
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   for(std::vector<TracerouteRecord>::const_iterator iterator = records.begin();
+       iterator != records.end(); iterator++) {
+      enqueue(*iterator);
+   }
+}
+
+
+// ###### Insert batch of Ping summaries ####################################
+void ResultsWriter::insert(const std::vector<PingSummaryRecord>& records)
+{
+   std::lock_guard<std::mutex> lock(InsertMutex);
+   beginInsert();
+   for(std::vector<PingSummaryRecord>::const_iterator iterator = records.begin();
+       iterator != records.end(); iterator++) {
+      enqueue(*iterator);
+   }
+}
+
+
+// ###### Enqueue or write tuple ############################################
+void ResultsWriter::enqueue(const std::string& tuple)
+{
+   if(Queue.empty()) {
+      write(tuple);
+   }
+   else {
+      ResultsQueueEntry* entry = beginEnqueue();
+      if(entry) {
+         entry->Result = tuple;
+         finishEnqueue();
+      }
+   }
+}
+
+
+// ###### Enqueue or write Ping result ######################################
+void ResultsWriter::enqueue(const PingRecord& record)
+{
+   if(Queue.empty()) {
+      write(record);
+   }
+   else {
+      ResultsQueueEntry* entry = beginEnqueue();
+      if(entry) {
+         entry->Result = record;
+         finishEnqueue();
+      }
+   }
+}
+
+
+// ###### Enqueue or write Traceroute result ################################
+void ResultsWriter::enqueue(const TracerouteRecord& record)
+{
+   if(Queue.empty()) {
+      write(record);
+   }
+   else {
+      ResultsQueueEntry* entry = beginEnqueue();
+      if(entry) {
+         // NOTE: If the entry already holds a Traceroute result, its hops
+         //       vector keeps its capacity. So, there is usually no memory
+         //       allocation here.
+         entry->Result = record;
+         finishEnqueue();
+      }
+   }
+}
+
+
+// ###### Enqueue or write Ping summary #####################################
+void ResultsWriter::enqueue(const PingSummaryRecord& record)
+{
+   if(Queue.empty()) {
+      write(record);
+   }
+   else {
+      ResultsQueueEntry* entry = beginEnqueue();
+      if(entry) {
+         entry->Result = record;
+         finishEnqueue();
+      }
+   }
+}
+
+
+// ###### Begin insert() call ##############################################
+void ResultsWriter::beginInsert()
+{
+   InsertBlocked  = false;
+   InsertTimedOut = false;
+}
+
+
+// ###### Get free queue entry ##############################################
+ResultsQueueEntry* ResultsWriter::beginEnqueue()
+{
+   const size_t tail = QueueTail.load(std::memory_order_relaxed);
+   if(tail - QueueHead.load() >= Queue.size()) {
+      // ====== Queue is full -> wait for the writer thread ==================
+      // The measurement thread is blocked for at most MaxBlockingTime per
+      // insert() call. If the writer cannot keep up, the result and all
+      // further results of the call are dropped.
+      if(InsertTimedOut) {
+         Dropped++;
+         return(nullptr);
+      }
+      if(!InsertBlocked) {
+         Blocked++;
+         InsertBlocked  = true;
+         InsertDeadline = std::chrono::steady_clock::now() +
+                             std::chrono::milliseconds(MaxBlockingTime);
+      }
+      std::unique_lock<std::mutex> lock(WakeMutex);
+      InserterWaiting.store(true);
+      const bool hasSpace = SpaceCondition.wait_until(lock, InsertDeadline, [&]() {
+         return(tail - QueueHead.load() < Queue.size());
+      });
+      InserterWaiting.store(false);
+      if(!hasSpace) {
+         InsertTimedOut = true;
+         Dropped++;
+         return(nullptr);
+      }
+   }
+   return(&Queue[tail & (Queue.size() - 1)]);
+}
+
+
+// ###### Hand filled queue entry over to writer thread #####################
+void ResultsWriter::finishEnqueue()
+{
+   QueueTail.store(QueueTail.load(std::memory_order_relaxed) + 1);
+   if(WriterWaiting.load()) {
+      std::lock_guard<std::mutex> lock(WakeMutex);
+      WakeCondition.notify_one();
+   }
+}
+
+
+// ###### Writer thread #####################################################
+void ResultsWriter::runWriterThread()
+{
+   size_t head = QueueHead.load(std::memory_order_relaxed);
+   while(true) {
+      // ====== Write queued results ========================================
+      const size_t tail = QueueTail.load(std::memory_order_acquire);
+      if(head != tail) {
+         while(head != tail) {
+            const ResultsQueueEntry& entry = Queue[head & (Queue.size() - 1)];
+            switch(entry.Result.which()) {
+               case ResultsQueueEntry::PingEntry:
+                  write(boost::get<PingRecord>(entry.Result));
+                break;
+               case ResultsQueueEntry::TracerouteEntry:
+                  write(boost::get<TracerouteRecord>(entry.Result));
+                break;
+               case ResultsQueueEntry::SummaryEntry:
+                  write(boost::get<PingSummaryRecord>(entry.Result));
+                break;
+               default:
+                  write(boost::get<std::string>(entry.Result));
+                break;
+            }
+            head++;
+            // NOTE: Sequentially consistent with InserterWaiting. So, either
+            //       a waiting inserter sees the new head, or it is woken up.
+            QueueHead.store(head);
+            if(InserterWaiting.load()) {
+               std::lock_guard<std::mutex> lock(WakeMutex);
+               SpaceCondition.notify_one();
+            }
+         }
+      }
+
+      // ====== Wait for new results ========================================
+      else {
+         if(StopWriter.load()) {
+            break;
+         }
+         std::unique_lock<std::mutex> lock(WakeMutex);
+         WriterWaiting.store(true);
+         if( (QueueTail.load() == head) && (!StopWriter.load()) ) {
+            WakeCondition.wait_for(lock, std::chrono::milliseconds(WriterWakeUp));
+         }
+         WriterWaiting.store(false);
+      }
+
+      // ====== Check, whether it is time for starting a new transaction =====
+      checkTransactionLength();
+   }
+}
+
+
+// ###### Write tuple #######################################################
+void ResultsWriter::write(const std::string& tuple)
+{
+   Buffer.clear();
+   if(Format == Binary) {
+      BinaryEncoder.encode(Buffer, tuple);
+   }
+   else {
+      Buffer += tuple;
+      Buffer += '\n';
+   }
+   if(!writeBuffer()) {
+      write(tuple);
+   }
+   else if(WriteIndex) {
+      Index.addTuple();
+   }
+}
+
+
+// ###### Write Ping result #################################################
+void ResultsWriter::write(const PingRecord& record)
+{
+   Buffer.clear();
+   if(Format == Binary) {
+      BinaryEncoder.encode(Buffer, record);
+   }
+   else if(Format == PostgreSQLCopy) {
+      Formatter.formatPingCopy(Buffer, record);
+   }
+   else {
+      Formatter.formatPing(Buffer, record);
+   }
+   if(!writeBuffer()) {
+      write(record);
+   }
+   else if(WriteIndex) {
+      Index.add(record);
+   }
+}
+
+
+// ###### Write Traceroute result ###########################################
+void ResultsWriter::write(const TracerouteRecord& record)
+{
+   Buffer.clear();
+
+   // ====== Binary format ==================================================
+   if(Format == Binary) {
+      BinaryEncoder.encode(Buffer, record);
+   }
+
+   // ====== PostgreSQL COPY rows, one per hop ==============================
+   else if(Format == PostgreSQLCopy) {
+      Formatter.formatTracerouteCopy(Buffer, record);
+   }
+
+   // ====== Path dictionary: write known path as reference ================
+   else if(Format == PathDictionaryText) {
+      std::map<uint64_t, std::vector<TracerouteHopRecord>>::iterator found =
+         PathDictionary.find(record.PathHash);
+      bool samePath = false;
+      if(found != PathDictionary.end()) {
+         const std::vector<TracerouteHopRecord>& knownHops = found->second;
+         samePath = (knownHops.size() == record.Hops.size());
+         for(size_t i = 0; samePath && (i < knownHops.size()); i++) {
+            samePath = (knownHops[i].Hop     == record.Hops[i].Hop) &&
+                       (knownHops[i].Address == record.Hops[i].Address);
+         }
+      }
+      if(samePath) {
+         // Only the RTT differences and changed status values are written:
+         Formatter.formatTracerouteReference(Buffer, record, found->second);
+      }
+      else {
+         // New path (or hash collision) -> (re-)define it by writing it in full
+         PathDictionary[record.PathHash] = record.Hops;
+         Formatter.formatTraceroute(Buffer, record);
+      }
+   }
+
+   // ====== Write full path ================================================
+   else {
+      Formatter.formatTraceroute(Buffer, record);
+   }
+
+   if(!writeBuffer()) {
+      write(record);
+   }
+   else if(WriteIndex) {
+      Index.add(record);
+   }
+}
+
+
+// ###### Write Ping summary ################################################
+// The binary format stores a summary as tuple of its text form. There is no
+// table for summaries in the PostgreSQL COPY format.
+void ResultsWriter::write(const PingSummaryRecord& record)
+{
+   Buffer.clear();
+   if(Format == Binary) {
+      std::string tuple;
+      Formatter.formatPingSummary(tuple, record);
+      tuple.pop_back();   // Without newline
+      BinaryEncoder.encode(Buffer, tuple);
+   }
+   else if(Format == PostgreSQLCopy) {
+      return;
+   }
+   else {
+      Formatter.formatPingSummary(Buffer, record);
+   }
+   if(!writeBuffer()) {
+      write(record);
+   }
+   else if(WriteIndex) {
+      Index.add(record);
+   }
+}
+
+
+// ###### Write formatted record from buffer ################################
+// Returns false, if the record has to be formatted and written again: the
+// append log segment is full, and a new one has been started. Since the
+// formatting state (binary address dictionary, path dictionary) is per file,
+// the record has to be formatted again for the new segment.
+bool ResultsWriter::writeBuffer()
+{
+   if(LogSegmentSize > 0) {
+      if(!Log.append(Buffer.data(), Buffer.size())) {
+         if(Inserts > 0) {
+            changeFile();
+            return(false);
+         }
+         HPCT_LOG(error) << "Unable to write record of " << Buffer.size()
+                         << " bytes into append log segment " << TargetFileName << " -> dropped";
+         return(true);
+      }
+   }
+   else {
+      OutputStream.write(Buffer.data(), Buffer.size());
+   }
    Inserts++;
+   return(true);
+}
+
+
+// ###### Write sidecar index of the current file ##########################
+// The index is moved into place before the results file. Then, a results
+// file never appears without its index.
+void ResultsWriter::writeIndex()
+{
+   if(BlockCompressor) {
+      Index.setBlockOffsets(BlockCompressor->getBlockOffsets());
+   }
+   const boost::filesystem::path tempIndexName   = TempFileName.string()   + ".idx";
+   const boost::filesystem::path targetIndexName = TargetFileName.string() + ".idx";
+   if(!Index.write(tempIndexName.string())) {
+      HPCT_LOG(warning) << "Unable to write index " << tempIndexName;
+      return;
+   }
+   if(chown(tempIndexName.c_str(), UID, GID) != 0) {
+      HPCT_LOG(warning) << "Setting ownership of " << tempIndexName
+                        << " to UID " << UID << ", GID " << GID
+                        << " failed: " << strerror(errno);
+   }
+   boost::filesystem::rename(tempIndexName, targetIndexName);
 }
 
 
@@ -200,19 +826,35 @@ ResultsWriter* ResultsWriter::makeResultsWriter(std::set<ResultsWriter*>&
                                                 const unsigned int              resultsTransactionLength,
                                                 const uid_t                     uid,
                                                 const gid_t                     gid,
-                                                const ResultsWriterCompressor   compressor)
+                                                const ResultsWriterCompressor   compressor,
+                                                const ResultsWriterFormat       format,
+                                                const size_t                    queueLength,
+                                                const bool                      shared)
 {
    if(!resultsDirectory.empty()) {
+      // ====== Shared writer: use existing one for this format =============
+      // All sources write into the same results files. The source address
+      // is part of each record.
+      if(shared) {
+         for(std::set<ResultsWriter*>::iterator iterator = resultsWriterSet.begin();
+             iterator != resultsWriterSet.end(); iterator++) {
+            if( ((*iterator)->Shared) && ((*iterator)->FormatName == resultsFormat) ) {
+               return(*iterator);
+            }
+         }
+      }
+
+      // ====== Create new writer ===========================================
       std::string uniqueID =
          resultsFormat + "-" +
          str(boost::format("P%d") % getpid()) + "-" +   /* Better: boost::this_process::get_id() */
-         sourceAddress.to_string() + "-" +
+         ((shared) ? std::string("shared") : sourceAddress.to_string()) + "-" +
          boost::posix_time::to_iso_string(boost::posix_time::microsec_clock::universal_time());
       replace(uniqueID.begin(), uniqueID.end(), ' ', '-');
 
       ResultsWriter* resultsWriter =
          new ResultsWriter(resultsDirectory, uniqueID, resultsFormat, resultsTransactionLength,
-                           uid, gid, compressor);
+                           uid, gid, compressor, format, queueLength, shared);
       if(resultsWriter->prepare() == true) {
          resultsWriterSet.insert(resultsWriter);
          return(resultsWriter);
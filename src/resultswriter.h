@@ -32,21 +32,64 @@
 #ifndef RESULTSWRITER_H
 #define RESULTSWRITER_H
 
+#include "appendlog.h"
+#include "binaryresults.h"
+#include "resultsformatter.h"
+#include "resultsindex.h"
+#include "resultsrecord.h"
+#include "resultstransport.h"
+
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/asio/ip/address.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <boost/variant.hpp>
+
+
+class ParallelCompressor;
 
 
 enum ResultsWriterCompressor {
    None  = 0,
    GZip  = 1,
-   BZip2 = 2
+   BZip2 = 2,
    // XZ = 3
+   ZStd  = 4
+};
+
+enum ResultsWriterFormat {
+   PlainText          = 0,   // One line per ping, one line per traceroute hop
+   PathDictionaryText = 1,   // Like PlainText, but a path already written to
+                             // the current file is written as reference only
+   Binary             = 2,   // Binary records (see binaryresults.h)
+   PostgreSQLCopy     = 3    // PostgreSQL COPY text rows for table Ping or
+                             // Traceroute (see SQL/schema.sql)
+};
+
+
+// Entry of the queue between measurement thread and writer thread. It holds
+// one of the result types, i.e. its size is the size of the largest type:
+struct ResultsQueueEntry
+{
+   enum ResultsQueueEntryType {   // Index of the type in Result
+      TupleEntry      = 0,
+      PingEntry       = 1,
+      TracerouteEntry = 2,
+      SummaryEntry    = 3
+   };
+   boost::variant<std::string, PingRecord,
+                  TracerouteRecord, PingSummaryRecord> Result;
 };
 
 
@@ -59,13 +102,36 @@ class ResultsWriter
                  const unsigned int            transactionLength,
                  const uid_t                   uid,
                  const gid_t                   gid,
-                 const ResultsWriterCompressor compressor);
+                 const ResultsWriterCompressor compressor,
+                 const ResultsWriterFormat     format      = PlainText,
+                 const size_t                  queueLength = 0,
+                 const bool                    shared      = false);
    virtual ~ResultsWriter();
 
    bool prepare();
    bool changeFile(const bool createNewFile = true);
    bool mayStartNewTransaction();
    void insert(const std::string& tuple);
+   void insert(const PingRecord& record);
+   void insert(const TracerouteRecord& record);
+   void insert(const std::vector<PingRecord>& records);
+   void insert(const std::vector<TracerouteRecord>& records);
+   void insert(const std::vector<PingSummaryRecord>& records);
+
+   static bool configureZstd(const int          level,
+                             const unsigned int workers,
+                             const std::string& dictionaryFileName);
+   static bool configureParallelCompression(const unsigned int workers);
+   static bool configureAppendLog(const size_t segmentSize);
+   static bool configureCollector(const std::string& collectorAddress,
+                                  const std::string& spoolDirectory,
+                                  const uid_t        uid,
+                                  const gid_t        gid);
+   static void closeCollector();
+   static bool configureIndex(const bool writeIndex);
+
+   inline unsigned long long getDropped() const { return(Dropped.load()); }
+   inline unsigned long long getBlocked() const { return(Blocked.load()); }
 
    static ResultsWriter* makeResultsWriter(std::set<ResultsWriter*>&       resultsWriterSet,
                                            const boost::asio::ip::address& sourceAddress,
@@ -74,9 +140,28 @@ class ResultsWriter
                                            const unsigned int              resultsTransactionLength,
                                            const uid_t                     uid,
                                            const gid_t                     gid,
-                                           const ResultsWriterCompressor   compressor = BZip2);
+                                           const ResultsWriterCompressor   compressor  = BZip2,
+                                           const ResultsWriterFormat       format      = PlainText,
+                                           const size_t                    queueLength = 0,
+                                           const bool                      shared      = false);
 
    protected:
+   void enqueue(const std::string& tuple);
+   void enqueue(const PingRecord& record);
+   void enqueue(const TracerouteRecord& record);
+   void enqueue(const PingSummaryRecord& record);
+   void write(const std::string& tuple);
+   void write(const PingRecord& record);
+   void write(const TracerouteRecord& record);
+   void write(const PingSummaryRecord& record);
+   bool writeBuffer();
+   void writeIndex();
+   bool checkTransactionLength();
+   void beginInsert();
+   ResultsQueueEntry* beginEnqueue();
+   void finishEnqueue();
+   void runWriterThread();
+
    const boost::filesystem::path         Directory;
    const std::string                     UniqueID;
    const std::string                     FormatName;
@@ -84,6 +169,8 @@ class ResultsWriter
    const uid_t                           UID;
    const gid_t                           GID;
    const ResultsWriterCompressor         Compressor;
+   const ResultsWriterFormat             Format;
+   const bool                            Shared;           // Used by multiple services
 
    boost::filesystem::path               TempFileName;
    boost::filesystem::path               TargetFileName;
@@ -92,6 +179,61 @@ class ResultsWriter
    std::ofstream                         OutputFile;
    boost::iostreams::filtering_ostream   OutputStream;
    std::chrono::steady_clock::time_point OutputCreationTime;
+
+   // Paths written in full into the current file, by path hash:
+   std::map<uint64_t, std::vector<TracerouteHopRecord>> PathDictionary;
+
+   // Binary format state of the current file, text formatter, and buffer:
+   BinaryResultsEncoder                  BinaryEncoder;
+   ResultsFormatter                      Formatter;
+   std::string                           Buffer;
+
+   // Sidecar index of the current file (if WriteIndex is set), with the
+   // block-parallel compressor providing the block offsets:
+   ResultsIndex                          Index;
+   std::shared_ptr<ParallelCompressor>   BlockCompressor;
+   static bool                           WriteIndex;
+
+   // Append log segment, instead of results file (if LogSegmentSize > 0):
+   AppendLogWriter                       Log;
+   static size_t                         LogSegmentSize;
+
+   // Transport to collector, instead of results files (if configured):
+   // The results file contents are collected as batch, which is sent to the
+   // collector when the transaction is complete. The transaction length is
+   // at most CollectorBatchInterval then.
+   std::string                           Batch;
+   static ResultsTransport*              Transport;
+   static const unsigned int             CollectorBatchInterval = 5;   // s
+
+   // Serialises insertions of multiple services into a shared writer:
+   std::mutex                            InsertMutex;
+
+   // ====== Asynchronous writing ===========================================
+   // With a queue, the measurement thread only copies the results into a
+   // single-producer/single-consumer ring (multiple services of a shared
+   // writer are serialised by InsertMutex). Formatting, compression and file
+   // rotation are done by the writer thread.
+   std::vector<ResultsQueueEntry>        Queue;            // Size is power of 2
+   std::atomic<size_t>                   QueueHead;        // Next to be written
+   std::atomic<size_t>                   QueueTail;        // Next to be filled
+   std::atomic<bool>                     WriterWaiting;
+   std::atomic<bool>                     InserterWaiting;
+   std::atomic<bool>                     StopWriter;
+   std::mutex                            WakeMutex;
+   std::condition_variable               WakeCondition;    // Wakes writer thread
+   std::condition_variable               SpaceCondition;   // Wakes inserter
+   std::thread                           WriterThread;
+   std::atomic<unsigned long long>       Dropped;          // Queue full -> dropped
+   std::atomic<unsigned long long>       Blocked;          // Queue full -> waited
+   unsigned long long                    ReportedDropped;
+   // Blocking bound of the current insert() call (protected by InsertMutex):
+   std::chrono::steady_clock::time_point InsertDeadline;
+   bool                                  InsertBlocked;    // Deadline is set
+   bool                                  InsertTimedOut;   // Drop remaining results
+
+   static const unsigned int             MaxBlockingTime = 50;    // ms
+   static const unsigned int             WriterWakeUp    = 250;   // ms
 };
 
 #endif
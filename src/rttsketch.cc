@@ -0,0 +1,114 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "rttsketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+const int64_t RTTSketch::MaxRTT;
+
+
+// ###### Constructor #######################################################
+RTTSketch::RTTSketch()
+{
+   Count = 0;
+}
+
+
+// ###### Destructor ########################################################
+RTTSketch::~RTTSketch()
+{
+}
+
+
+// ###### Get bucket of RTT #################################################
+unsigned int RTTSketch::bucket(int64_t rtt)
+{
+   rtt = std::min(std::max((int64_t)0, rtt), MaxRTT);
+   if(rtt < 16) {
+      return((unsigned int)rtt);
+   }
+   unsigned int exponent = 4;
+   while((rtt >> (exponent + 1)) != 0) {
+      exponent++;
+   }
+   return((exponent - 3) * 16 + (unsigned int)((rtt >> (exponent - 4)) & 15));
+}
+
+
+// ###### Get RTT represented by bucket (centre of its range) ###############
+int64_t RTTSketch::value(const unsigned int bucket)
+{
+   if(bucket < 16) {
+      return(bucket);
+   }
+   const unsigned int shift = bucket / 16 - 1;
+   return(((int64_t)(16 + (bucket & 15)) << shift) + (((int64_t)1 << shift) >> 1));
+}
+
+
+// ###### Add RTT ###########################################################
+void RTTSketch::add(const int64_t rtt)
+{
+   Buckets[bucket(rtt)]++;
+   Count++;
+}
+
+
+// ###### Merge other sketch ################################################
+void RTTSketch::merge(const RTTSketch& sketch)
+{
+   for(std::map<unsigned int, unsigned int>::const_iterator iterator = sketch.Buckets.begin();
+       iterator != sketch.Buckets.end(); iterator++) {
+      Buckets[iterator->first] += iterator->second;
+   }
+   Count += sketch.Count;
+}
+
+
+// ###### Get quantile ######################################################
+// Like rttSketchQuantile() in SQL/schema.sql. Returns -1 for an empty sketch.
+int64_t RTTSketch::quantile(const double q) const
+{
+   const unsigned long long rank =
+      std::max(1ULL, (unsigned long long)std::ceil(q * (double)Count));
+   unsigned long long cumulative = 0;
+   for(std::map<unsigned int, unsigned int>::const_iterator iterator = Buckets.begin();
+       iterator != Buckets.end(); iterator++) {
+      cumulative += iterator->second;
+      if(cumulative >= rank) {
+         return(value(iterator->first));
+      }
+   }
+   return(-1);
+}
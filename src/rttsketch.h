@@ -0,0 +1,71 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef RTTSKETCH_H
+#define RTTSKETCH_H
+
+#include <map>
+#include <stdint.h>
+
+
+// ###### Mergeable sketch of RTTs ##########################################
+// Log-linear histogram of RTTs (in microseconds): each value below 16 has its
+// own bucket, larger values are sorted into 16 sub-buckets per power of two.
+// Then, the relative error of a quantile is at most 1/32. The bucket numbers
+// are the same as of rttSketchBucket() in SQL/schema.sql, i.e. sketches can
+// be merged with the sketches in table PingRollup.
+class RTTSketch
+{
+   public:
+   RTTSketch();
+   ~RTTSketch();
+
+   void add(const int64_t rtt);
+   void merge(const RTTSketch& sketch);
+   int64_t quantile(const double q) const;
+   inline void clear() { Buckets.clear(); Count = 0; }
+
+   inline unsigned long long count() const { return(Count); }
+   inline const std::map<unsigned int, unsigned int>& buckets() const {
+      return(Buckets);
+   }
+
+   static unsigned int bucket(int64_t rtt);
+   static int64_t value(const unsigned int bucket);
+
+   static const int64_t MaxRTT = 0x7fffffff;   // INTEGER in SQL
+
+   private:
+   std::map<unsigned int, unsigned int> Buckets;   // Bucket -> count
+   unsigned long long                   Count;
+};
+
+#endif
@@ -0,0 +1,202 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+
+// Tests of the append log: reading of records, and recovery of the segment
+// of a crashed writer up to its last complete record.
+
+#include "appendlog.h"
+#include "test-check.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+// ###### Read file #########################################################
+static std::string readFile(const std::string& fileName)
+{
+   std::ifstream     file(fileName, std::ios_base::in | std::ios_base::binary);
+   std::stringstream contents;
+   contents << file.rdbuf();
+   return(contents.str());
+}
+
+
+// ###### Write file ########################################################
+static void writeFile(const std::string& fileName, const std::string& contents)
+{
+   std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+   file.write(contents.data(), contents.size());
+   CHECK(file.good());
+}
+
+
+// ###### Read all records of a segment #####################################
+// Returns the result of the last call of next().
+static AppendLogReader::ReadResult readSegment(const std::string& fileName,
+                                               std::string&       records,
+                                               unsigned int&      count)
+{
+   AppendLogReader reader;
+   CHECK(reader.open(fileName));
+   records.clear();
+   count = 0;
+   const char*                 data;
+   size_t                      length;
+   AppendLogReader::ReadResult result;
+   while( (result = reader.next(data, length)) == AppendLogReader::Record ) {
+      records.append(data, length);
+      count++;
+   }
+   return(result);
+}
+
+
+// ###### Main program ######################################################
+int main()
+{
+   char directoryName[] = "/tmp/test-appendlog-XXXXXX";
+   CHECK(mkdtemp(directoryName) != nullptr);
+   const std::string directory(directoryName);
+   const std::string segmentName = directory + "/Ping-000000001.hpctlog";
+   const std::string crashedName = directory + "/crashed.hpctlog";
+   const size_t      segmentSize = 4096;
+
+   // ====== Write records ==================================================
+   AppendLogWriter writer;
+   CHECK(writer.create(directory + "/tmp.hpctlog", segmentName, segmentSize, ALCT_Text,
+                       getuid(), getgid()));
+   std::string written;
+   for(unsigned int i = 0; i < 3; i++) {
+      const std::string line = "#P record " + std::to_string(i) + std::string(i, 'x') + "\n";
+      CHECK(writer.append(line.data(), line.size()));
+      written += line;
+   }
+   CHECK(writer.getRecords() == 3);
+   const size_t endOfRecords = writer.getUsed();
+
+   // ====== Read active segment ============================================
+   std::string  records;
+   unsigned int count;
+   {
+      AppendLogReader reader;
+      CHECK(reader.open(segmentName));
+      CHECK(reader.getContentType() == ALCT_Text);
+      CHECK(!reader.isClosed());
+      CHECK(reader.isLocked());
+   }
+   CHECK(readSegment(segmentName, records, count) == AppendLogReader::NoData);
+   CHECK(count == 3);
+   CHECK(records == written);
+
+   // ====== Crashed writer =================================================
+   // A copy of the active segment is a segment left by a crashed writer:
+   // in active state, and not locked.
+   const std::string image = readFile(segmentName);
+   CHECK(image.size() == segmentSize);
+
+   // ------ Crash before the length field of a record has been written ----
+   // The payload and CRC are there, but the length is still 0.
+   const std::string lost = "#P lost record\n";
+   std::string crashed = image;
+   crashed.replace(endOfRecords + 8, lost.size(), lost);
+   crashed.replace(endOfRecords + 4, 4, std::string("\x12\x34\x56\x78", 4));
+   writeFile(crashedName, crashed);
+   {
+      AppendLogReader reader;
+      CHECK(reader.open(crashedName));
+      CHECK(!reader.isClosed());
+      CHECK(!reader.isLocked());
+   }
+   CHECK(readSegment(crashedName, records, count) == AppendLogReader::NoData);
+   CHECK(count == 3);
+   CHECK(records == written);
+
+   // ------ Torn record: length written, payload incomplete ---------------
+   // The CRC does not match, so the record is not returned.
+   const uint32_t lostLength = lost.size();
+   crashed.replace(endOfRecords, 4, std::string((const char*)&lostLength, 4));
+   writeFile(crashedName, crashed);
+   CHECK(readSegment(crashedName, records, count) == AppendLogReader::Corrupt);
+   CHECK(count == 3);
+   CHECK(records == written);
+
+   // ------ Truncated segment file -----------------------------------------
+   // Within the frame header of a record:
+   writeFile(crashedName, image.substr(0, endOfRecords + 4));
+   CHECK(readSegment(crashedName, records, count) == AppendLogReader::EndOfSegment);
+   CHECK(count == 3);
+   CHECK(records == written);
+   // Within the payload of the last record:
+   writeFile(crashedName, image.substr(0, endOfRecords - 4));
+   CHECK(readSegment(crashedName, records, count) == AppendLogReader::Corrupt);
+   CHECK(count == 2);
+   CHECK(records == written.substr(0, records.size()));
+
+   // ====== Closed segment =================================================
+   CHECK(writer.append(lost.data(), lost.size()));
+   written += lost;
+   const size_t dataEnd = writer.getUsed();
+   writer.close();
+   // The unused space is released, up to an empty frame header:
+   CHECK(readFile(segmentName).size() == dataEnd + AppendLogWriter::FrameHeaderSize);
+   CHECK(readSegment(segmentName, records, count) == AppendLogReader::EndOfSegment);
+   CHECK(count == 4);
+   CHECK(records == written);
+   {
+      AppendLogReader reader;
+      CHECK(reader.open(segmentName));
+      CHECK(reader.isClosed());
+      CHECK(!reader.isLocked());
+   }
+
+   // ====== Full segment ===================================================
+   const std::string big(segmentSize, 'x');
+   CHECK(writer.create(directory + "/tmp.hpctlog", segmentName, segmentSize, ALCT_Binary,
+                       getuid(), getgid()));
+   CHECK(!writer.append(big.data(), big.size()));
+   CHECK(writer.append(big.data(), segmentSize - sizeof(AppendLogHeader) - AppendLogWriter::FrameHeaderSize));
+   CHECK(!writer.append("x", 1));
+   writer.close();
+   CHECK(readFile(segmentName).size() == segmentSize);
+   CHECK(readSegment(segmentName, records, count) == AppendLogReader::EndOfSegment);
+   CHECK(count == 1);
+
+   unlink(segmentName.c_str());
+   unlink(crashedName.c_str());
+   rmdir(directoryName);
+   std::cout << "OK" << std::endl;
+   return 0;
+}
@@ -0,0 +1,229 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+
+// Round trip of the binary results format: the records are encoded, then
+// converted back by hpctconvert. Its output has to be identical to the text
+// format of the records.
+// Usage: test-binaryresults path_to_hpctconvert
+
+#include "binaryresults.h"
+#include "resultsformatter.h"
+#include "test-check.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+// ###### Make Ping record ##################################################
+static PingRecord makePing(const char*    source,
+                           const char*    destination,
+                           const uint64_t timeStamp,
+                           const int64_t  rtt)
+{
+   PingRecord record;
+   record.Source       = boost::asio::ip::address::from_string(source);
+   record.Destination  = boost::asio::ip::address::from_string(destination);
+   record.TimeStamp    = timeStamp;
+   record.Checksum     = (uint16_t)(timeStamp * 7919);
+   record.Status       = 255;
+   record.RTT          = rtt;
+   record.TrafficClass = 0xb8;
+   return(record);
+}
+
+
+// ###### Make Traceroute record ############################################
+static TracerouteRecord makeTraceroute(const char*        source,
+                                       const char*        destination,
+                                       const uint64_t     timeStamp,
+                                       const unsigned int round)
+{
+   TracerouteRecord record;
+   record.Source       = boost::asio::ip::address::from_string(source);
+   record.Destination  = boost::asio::ip::address::from_string(destination);
+   record.TimeStamp    = timeStamp;
+   record.Round        = round;
+   record.Checksum     = 0xbeef;
+   record.TotalHops    = 3;
+   record.StatusFlags  = 0x100;
+   record.PathHash     = 0xfedcba9876543210ULL;   // Uses all 64 bits
+   record.TrafficClass = 0;
+   const char* hops[3] = { "10.0.0.1", "10.1.0.1", destination };
+   for(unsigned int i = 0; i < 3; i++) {
+      TracerouteHopRecord hop;
+      hop.Hop     = i + 1;
+      hop.Status  = (i < 2) ? 3 : 255;
+      hop.RTT     = 1000 * (i + 1) + round;
+      hop.Address = boost::asio::ip::address::from_string(
+                       (record.Destination.is_v4() || (i == 2)) ? hops[i] : "2001:db8::1");
+      record.Hops.push_back(hop);
+   }
+   return(record);
+}
+
+
+// ###### Convert binary results with hpctconvert, and compare with text ###
+static void checkConversion(const char*        hpctconvert,
+                            const std::string& binary,
+                            const std::string& text)
+{
+   char inputName[]  = "/tmp/test-binaryresults-XXXXXX";
+   const int fd = mkstemp(inputName);
+   CHECK(fd >= 0);
+   CHECK(write(fd, binary.data(), binary.size()) == (ssize_t)binary.size());
+   close(fd);
+   const std::string outputName = std::string(inputName) + ".txt";
+   const std::string command    = std::string(hpctconvert) + " -q -o " + outputName + " " + inputName;
+   const int result = system(command.c_str());
+   unlink(inputName);
+   CHECK(result == 0);
+
+   std::ifstream     outputFile(outputName, std::ios_base::in | std::ios_base::binary);
+   std::stringstream converted;
+   converted << outputFile.rdbuf();
+   unlink(outputName.c_str());
+   if(converted.str() != text) {
+      std::cerr << "Expected:" << std::endl << text
+                << "Got:" << std::endl << converted.str();
+   }
+   CHECK(converted.str() == text);
+}
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   if(argc < 2) {
+      std::cerr << "Usage: " << argv[0] << " path_to_hpctconvert" << std::endl;
+      return 1;
+   }
+
+   // ====== Encode results, and format them as text ========================
+   // Timestamps go backwards and forwards (zigzag encoding), RTTs include
+   // -1 for time-outs, and the source address changes in between.
+   BinaryResultsEncoder encoder;
+   ResultsFormatter     formatter;
+   std::string          binary;
+   std::string          text;
+   const uint64_t       t0 = 1600000000123456ULL;
+
+   const PingRecord pings[] = {
+      makePing("192.168.0.1", "8.8.8.8",           t0,           12345),
+      makePing("192.168.0.1", "8.8.4.4",           t0 + 1000000, -1),
+      makePing("192.168.0.1", "8.8.8.8",           t0 + 999999,  0),
+      makePing("2001:db8::2", "2001:4860::8888",   t0 + 5000000, 987654321),
+      makePing("2001:db8::2", "2001:4860::8844",   t0 - 1,       1)
+   };
+   for(unsigned int i = 0; i < sizeof(pings) / sizeof(pings[0]); i++) {
+      encoder.encode(binary, pings[i]);
+      formatter.formatPing(text, pings[i]);
+   }
+   const TracerouteRecord traceroutes[] = {
+      makeTraceroute("192.168.0.1", "8.8.8.8",         t0 + 10000000, 0),
+      makeTraceroute("192.168.0.1", "8.8.8.8",         t0 + 10000001, 1),
+      makeTraceroute("2001:db8::2", "2001:4860::8888", t0 + 20000000, 0)
+   };
+   for(unsigned int i = 0; i < sizeof(traceroutes) / sizeof(traceroutes[0]); i++) {
+      encoder.encode(binary, traceroutes[i]);
+      formatter.formatTraceroute(text, traceroutes[i]);
+   }
+   const std::string tuple = "#P 10.0.0.1 10.0.0.2 1 2 3 4 5";
+   encoder.encode(binary, tuple);
+   text += tuple + "\n";
+
+   // ====== Decode in-process ==============================================
+   std::istringstream  input(binary);
+   BinaryResultsReader reader(input);
+   unsigned int        records = 0;
+   BinaryResultsReader::RecordType recordType;
+   while( (recordType = reader.next()) != BinaryResultsReader::EndOfInput ) {
+      CHECK(recordType != BinaryResultsReader::FormatError);
+      records++;
+   }
+   CHECK(records == 9);
+
+   // ====== Convert with hpctconvert =======================================
+   checkConversion(argv[1], binary, text);
+
+   // ====== Truncated input has to be reported =============================
+   std::istringstream  truncatedInput(binary.substr(0, binary.size() - 3));
+   BinaryResultsReader truncatedReader(truncatedInput);
+   records = 0;
+   while( ((recordType = truncatedReader.next()) != BinaryResultsReader::EndOfInput) &&
+          (recordType != BinaryResultsReader::FormatError) ) {
+      records++;
+   }
+   CHECK(recordType == BinaryResultsReader::FormatError);
+   CHECK(records == 8);
+
+   // ====== Shared results file (--resultsshared) ==========================
+   // The results of all sources are written into one file, so the source
+   // changes from record to record ('S' records), also back to the source
+   // of the header, and between address families.
+   BinaryResultsEncoder sharedEncoder;
+   ResultsFormatter     sharedFormatter;
+   std::string          sharedBinary;
+   std::string          sharedText;
+   const char*          sources[3] = { "192.168.0.1", "192.168.1.1", "2001:db8::2" };
+   for(unsigned int i = 0; i < 12; i++) {
+      const PingRecord ping =
+         makePing(sources[i % 3], (i % 3 == 2) ? "2001:4860::8888" : "8.8.8.8",
+                  t0 + 1000 * i, 100 + i);
+      sharedEncoder.encode(sharedBinary, ping);
+      sharedFormatter.formatPing(sharedText, ping);
+      if(i % 4 == 3) {
+         const TracerouteRecord traceroute = makeTraceroute(sources[i % 3], "8.8.8.8", t0 + 1000 * i + 1, 0);
+         sharedEncoder.encode(sharedBinary, traceroute);
+         sharedFormatter.formatTraceroute(sharedText, traceroute);
+      }
+   }
+   std::istringstream  sharedInput(sharedBinary);
+   BinaryResultsReader sharedReader(sharedInput);
+   for(unsigned int i = 0; i < 12; i++) {
+      CHECK(sharedReader.next() == BinaryResultsReader::PingResult);
+      CHECK(sharedReader.ping().Source == boost::asio::ip::address::from_string(sources[i % 3]));
+      if(i % 4 == 3) {
+         CHECK(sharedReader.next() == BinaryResultsReader::TracerouteResult);
+         CHECK(sharedReader.traceroute().Source == boost::asio::ip::address::from_string(sources[i % 3]));
+      }
+   }
+   CHECK(sharedReader.next() == BinaryResultsReader::EndOfInput);
+   checkConversion(argv[1], sharedBinary, sharedText);
+
+   std::cout << "OK" << std::endl;
+   return 0;
+}
@@ -0,0 +1,179 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+
+// Tests of the DestinationRegistry: insertion, lookup, removal with
+// backward-shift deletion in the hash index, and reuse of IDs.
+
+#include "destinationregistry.h"
+#include "test-check.h"
+
+#include <iostream>
+#include <map>
+
+
+// ###### Make destination ##################################################
+static DestinationInfo makeDestination(const unsigned int n, const uint8_t trafficClass = 0)
+{
+   if(n % 3 == 0) {
+      boost::asio::ip::address_v6::bytes_type bytes = { { 0x20, 0x01, 0x0d, 0xb8 } };
+      bytes[14] = (uint8_t)(n >> 8);
+      bytes[15] = (uint8_t)n;
+      return(DestinationInfo(boost::asio::ip::address_v6(bytes), trafficClass));
+   }
+   return(DestinationInfo(boost::asio::ip::address_v4(0x0a000000 + n), trafficClass));
+}
+
+
+// ###### Check registry against the expected contents ######################
+static void checkRegistry(const DestinationRegistry&              registry,
+                          const std::map<unsigned int, uint32_t>& expected,
+                          const unsigned int                      range)
+{
+   CHECK(registry.size() == expected.size());
+
+   // ====== Every destination is found by lookup ===========================
+   // This fails, if the backward shift breaks a probe sequence.
+   for(unsigned int n = 0; n < range; n++) {
+      const std::map<unsigned int, uint32_t>::const_iterator found = expected.find(n);
+      const uint32_t id = registry.find(makeDestination(n));
+      if(found != expected.end()) {
+         CHECK(id == found->second);
+         CHECK(registry.isValid(id));
+         CHECK(registry.at(registry.positionOf(id)) == makeDestination(n));
+      }
+      else {
+         CHECK(id == DestinationRegistry::InvalidID);
+      }
+   }
+
+   // ====== Iteration covers every destination exactly once ================
+   size_t count = 0;
+   for(size_t position = registry.first(); position != DestinationRegistry::EndPosition;
+       position = registry.next(position)) {
+      CHECK(registry.positionOf(registry.idAt(position)) == position);
+      count++;
+   }
+   CHECK(count == expected.size());
+}
+
+
+// ###### Main program ######################################################
+int main()
+{
+   DestinationRegistry               registry;
+   std::map<unsigned int, uint32_t>  expected;   // Destination number -> ID
+   const unsigned int                range = 1000;
+   bool                              inserted;
+
+   // ====== Insert destinations ============================================
+   // More than the initial 64 slots, so that the index is rehashed.
+   for(unsigned int n = 0; n < range; n++) {
+      const uint32_t id = registry.insert(makeDestination(n), inserted);
+      CHECK(inserted);
+      CHECK(id == n);
+      expected[n] = id;
+   }
+   checkRegistry(registry, expected, range);
+   CHECK(registry.maxID() == range);
+
+   // Duplicates are not inserted again. The traffic class distinguishes
+   // destinations.
+   CHECK(registry.insert(makeDestination(42), inserted) == expected[42]);
+   CHECK(!inserted);
+   const uint32_t otherTC = registry.insert(makeDestination(42, 0xb8), inserted);
+   CHECK(inserted);
+   CHECK(otherTC != expected[42]);
+   registry.removeAt(registry.positionOf(otherTC));
+   checkRegistry(registry, expected, range);
+
+   // ====== Remove destinations ============================================
+   // Every third destination, then check that all others are still found.
+   std::map<uint32_t, bool> freedIDs;
+   for(unsigned int n = 0; n < range; n += 3) {
+      const uint32_t id = expected[n];
+      registry.removeAt(registry.positionOf(id));
+      CHECK(!registry.isValid(id));
+      freedIDs[id] = true;
+      expected.erase(n);
+   }
+   checkRegistry(registry, expected, range);
+
+   // ====== Remove in iteration order, as Traceroute does ==================
+   // Removing moves the last destination into the position, so the position
+   // is checked again.
+   size_t position = registry.first();
+   while(position != DestinationRegistry::EndPosition) {
+      const uint32_t id = registry.idAt(position);
+      std::map<unsigned int, uint32_t>::iterator iterator = expected.begin();
+      while(iterator->second != id) {
+         iterator++;
+      }
+      if(iterator->first % 5 == 0) {
+         registry.removeAt(position);
+         freedIDs[id] = true;
+         expected.erase(iterator);
+         if(position >= registry.size()) {
+            break;
+         }
+      }
+      else {
+         position = registry.next(position);
+      }
+   }
+   checkRegistry(registry, expected, range);
+
+   // ====== Reinsert destinations ==========================================
+   // The IDs of removed destinations are reused, so maxID() does not grow.
+   // (The ID of the removed destination with the other traffic class is the
+   // oldest free ID, so it remains free.)
+   for(unsigned int n = 0; n < range; n++) {
+      if(expected.find(n) == expected.end()) {
+         const uint32_t id = registry.insert(makeDestination(n), inserted);
+         CHECK(inserted);
+         CHECK(freedIDs.erase(id) == 1);
+         expected[n] = id;
+      }
+   }
+   CHECK(freedIDs.empty());
+   CHECK(registry.maxID() == range + 1);
+   checkRegistry(registry, expected, range);
+
+   // ====== Clear ==========================================================
+   registry.clear();
+   CHECK(registry.empty());
+   CHECK(registry.first() == DestinationRegistry::EndPosition);
+   CHECK(registry.find(makeDestination(1)) == DestinationRegistry::InvalidID);
+   CHECK(registry.insert(makeDestination(1), inserted) == 0);
+
+   std::cout << "OK" << std::endl;
+   return 0;
+}
@@ -0,0 +1,187 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+
+// Tests of the ProbeTable: expiry of probes in the way of Ping, growth of
+// the window, sequence number wrap-around, rebasing of the send times, and
+// the reply address pool.
+
+#include "probetable.h"
+#include "test-check.h"
+
+#include <iostream>
+
+
+// ###### Remove expired probes, like Ping::processResults() ################
+static unsigned int expire(ProbeTable&                                  probes,
+                           const std::chrono::system_clock::time_point& now,
+                           const unsigned int                           expiration)
+{
+   unsigned int expired = 0;
+   for(unsigned int i = 0; i < probes.window(); i++) {
+      if( (probes.isUsed(i)) &&
+          (std::chrono::duration_cast<std::chrono::milliseconds>(now - probes.sendTime(i)).count() >= expiration) ) {
+         probes.remove(i);
+         expired++;
+      }
+   }
+   return(expired);
+}
+
+
+// ###### Main program ######################################################
+int main()
+{
+   DestinationRegistry destinations;
+   bool                inserted;
+   const uint32_t      id1 = destinations.insert(DestinationInfo(boost::asio::ip::address::from_string("10.0.0.1"), 0), inserted);
+   const uint32_t      id2 = destinations.insert(DestinationInfo(boost::asio::ip::address::from_string("10.0.0.2"), 0), inserted);
+   const std::chrono::system_clock::time_point t0 =
+      std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now());
+   ProbeTable   probes;
+   unsigned int index;
+
+   // ====== Add probes, with sequence number wrap-around ===================
+   // 200 probes, 10 ms apart, starting 100 before the wrap-around. This
+   // also grows the table beyond its initial capacity.
+   const unsigned short firstSeqNumber = 65436;
+   for(unsigned int i = 0; i < 200; i++) {
+      CHECK(probes.add((unsigned short)(firstSeqNumber + i), 0, 1 + (i % 30), (uint16_t)i,
+                       t0 + std::chrono::milliseconds(10 * i),
+                       (i % 2 == 0) ? id1 : id2));
+   }
+   CHECK(probes.size() == 200);
+   CHECK(probes.window() == 200);
+   CHECK(!probes.add((unsigned short)(firstSeqNumber + 150), 0, 1, 0, t0, id1));   // In use
+   for(unsigned int i = 0; i < 200; i++) {
+      CHECK(probes.find((unsigned short)(firstSeqNumber + i), index));
+      CHECK(index == i);
+      CHECK(probes.hop(index) == 1 + (i % 30));
+      CHECK(probes.destinationID(index) == ((i % 2 == 0) ? id1 : id2));
+      CHECK(probes.sendTime(index) == t0 + std::chrono::milliseconds(10 * i));
+   }
+   CHECK(!probes.find((unsigned short)(firstSeqNumber + 200), index));
+
+   // ====== Set a result ===================================================
+   CHECK(probes.find(5, index));   // After the wrap-around
+   probes.setResult(index, probes.sendTime(index) + std::chrono::microseconds(4321),
+                    boost::asio::ip::address::from_string("10.0.0.2"), Success);
+   const ResultEntry entry = probes.entry(index, destinations);
+   CHECK(entry.seqNumber() == 5);
+   CHECK(entry.status() == Success);
+   CHECK(entry.destinationID() == id2);
+   CHECK(std::chrono::duration_cast<std::chrono::microseconds>(entry.rtt()).count() == 4321);
+   CHECK(entry.destinationAddress() == boost::asio::ip::address::from_string("10.0.0.2"));
+
+   // ====== Reply address pool =============================================
+   // Each address is stored once, as long as probes refer to it.
+   const boost::asio::ip::address router = boost::asio::ip::address::from_string("10.9.9.9");
+   for(unsigned int i = 120; i < 130; i++) {
+      CHECK(probes.find((unsigned short)(firstSeqNumber + i), index));
+      probes.setResult(index, probes.sendTime(index) + std::chrono::microseconds(i), router, TimeExceeded);
+   }
+   CHECK(probes.replyAddresses() == 2);
+   for(unsigned int i = 120; i < 129; i++) {
+      CHECK(probes.find((unsigned short)(firstSeqNumber + i), index));
+      CHECK(probes.entry(index, destinations).destinationAddress() == router);
+      CHECK(probes.entry(index, destinations).status() == TimeExceeded);
+      probes.remove(index);
+   }
+   CHECK(probes.replyAddresses() == 2);
+   CHECK(probes.find((unsigned short)(firstSeqNumber + 129), index));
+   probes.remove(index);
+   CHECK(probes.replyAddresses() == 1);
+   // The free pool entry is reused for a new address:
+   CHECK(probes.find((unsigned short)(firstSeqNumber + 130), index));
+   probes.setResult(index, probes.sendTime(index), boost::asio::ip::address::from_string("2001:db8::1"), Success);
+   CHECK(probes.replyAddresses() == 2);
+   CHECK(probes.entry(index, destinations).destinationAddress() == boost::asio::ip::address::from_string("2001:db8::1"));
+
+   // ====== Expire probes ==================================================
+   // Expiration 1 s: probes sent before t0 + 500 ms have expired.
+   CHECK(expire(probes, t0 + std::chrono::milliseconds(1500), 1000) == 51);
+   CHECK(probes.size() == 139);
+   CHECK(!probes.find(firstSeqNumber, index));
+   CHECK(probes.find((unsigned short)(firstSeqNumber + 51), index));
+
+   // The next probe drops the unused slots at the beginning of the window:
+   CHECK(probes.add((unsigned short)(firstSeqNumber + 200), 0, 1, 0,
+                    t0 + std::chrono::milliseconds(2000), id1));
+   CHECK(probes.window() == 150);
+   CHECK(probes.find((unsigned short)(firstSeqNumber + 51), index));
+   CHECK(index == 0);
+   CHECK(probes.sendTime(index) == t0 + std::chrono::milliseconds(510));
+
+   // Expire everything, then the table restarts at the new sequence number:
+   CHECK(expire(probes, t0 + std::chrono::seconds(10), 1000) == 140);
+   CHECK(probes.size() == 0);
+   CHECK(probes.replyAddresses() == 0);
+   CHECK(probes.add(1000, 0, 1, 0, t0 + std::chrono::seconds(10), id1));
+   CHECK(probes.window() == 1);
+   CHECK(probes.find(1000, index));
+   CHECK(index == 0);
+   probes.remove(index);
+
+   // ====== Rebase: probe sent before the base time ========================
+   // The send times are stored relative to the first probe. An earlier
+   // send time (e.g. after a clock change) moves the base time back.
+   const std::chrono::system_clock::time_point t1 = t0 + std::chrono::seconds(60);
+   CHECK(probes.add(2000, 0, 1, 0, t1, id1));
+   CHECK(probes.add(2001, 0, 1, 0, t1 - std::chrono::seconds(30), id2));
+   CHECK(probes.find(2000, index));
+   CHECK(probes.sendTime(index) == t1);
+   CHECK(probes.find(2001, index));
+   CHECK(probes.sendTime(index) == t1 - std::chrono::seconds(30));
+
+   // ====== Rebase: send time beyond the 32-bit offset =====================
+   // More than 2^32 us (about 71 minutes) after the base time. The probes
+   // within the range keep their send times.
+   const std::chrono::system_clock::time_point t2 = t1 + std::chrono::minutes(80);
+   CHECK(probes.find(2001, index));
+   probes.remove(index);
+   CHECK(probes.add(2002, 0, 1, 0, t1 + std::chrono::minutes(30), id2));
+   CHECK(probes.add(2003, 0, 1, 0, t2, id1));
+   CHECK(probes.find(2002, index));
+   CHECK(probes.sendTime(index) == t1 + std::chrono::minutes(30));
+   CHECK(probes.find(2003, index));
+   CHECK(probes.sendTime(index) == t2);
+   // The oldest probe is out of range; its send time is truncated:
+   CHECK(probes.find(2000, index));
+   CHECK(probes.sendTime(index) == t2 - std::chrono::microseconds(0xffffffffLL));
+
+   // Expiry still works on the rebased send times:
+   CHECK(expire(probes, t2 + std::chrono::seconds(1), 10000) == 2);
+   CHECK(probes.size() == 1);
+   CHECK(probes.find(2003, index));
+
+   std::cout << "OK" << std::endl;
+   return 0;
+}
@@ -40,8 +40,8 @@
 #include <netinet/in.h>
 #include <netinet/ip.h>
 
+#include <algorithm>
 #include <functional>
-#include <boost/format.hpp>
 #include <boost/version.hpp>
 #include <iostream>
 #include <boost/interprocess/streams/bufferstream.hpp>
@@ -52,6 +52,14 @@
 #endif
 
 
+const size_t                          Traceroute::MaxTriggerQueueLength;
+const unsigned int                    Traceroute::TriggerTokenRate;
+const unsigned int                    Traceroute::TriggerTokenBurst;
+std::mutex                            Traceroute::TriggerTokenMutex;
+double                                Traceroute::TriggerTokens    = Traceroute::TriggerTokenBurst;
+std::chrono::steady_clock::time_point Traceroute::TriggerTokenTime = std::chrono::steady_clock::now();
+
+
 // ###### Constructor #######################################################
 Traceroute::Traceroute(ResultsWriter*                   resultsWriter,
                        const unsigned int               iterations,
@@ -64,7 +72,8 @@ Traceroute::Traceroute(ResultsWriter*                   resultsWriter,
                        const unsigned int               initialMaxTTL,
                        const unsigned int               finalMaxTTL,
                        const unsigned int               incrementMaxTTL,
-                       const unsigned int               priority)
+                       const unsigned int               priority,
+                       const unsigned long long         maxInterval)
    : TracerouteInstanceName(std::string("Traceroute(") + sourceAddress.to_string() + std::string(")")),
      ResultsOutput(resultsWriter),
      Iterations(iterations),
@@ -75,6 +84,7 @@ Traceroute::Traceroute(ResultsWriter*                   resultsWriter,
      InitialMaxTTL(initialMaxTTL),
      FinalMaxTTL(finalMaxTTL),
      IncrementMaxTTL(incrementMaxTTL),
+     MaxInterval(maxInterval),
      IOService(),
      SourceAddress(sourceAddress),
      ICMPSocket(IOService, (isIPv6() == true) ? boost::asio::ip::icmp::v6() : boost::asio::ip::icmp::v4()),
@@ -91,6 +101,11 @@ Traceroute::Traceroute(ResultsWriter*                   resultsWriter,
    LastHop             = 0xffffffff;
    ExpectingReply      = false;
    IterationNumber     = 0;
+   TriggeredRun        = false;
+   SavedRuns           = 0;
+   TransientCount      = 0;
+   IterationDeferred   = false;
+   IntervalScheduled   = false;
    MinTTL              = 1;
    MaxTTL              = InitialMaxTTL;
    TargetChecksumArray = new uint32_t[Rounds];
@@ -102,10 +117,12 @@ Traceroute::Traceroute(ResultsWriter*                   resultsWriter,
        destinationIterator != destinationArray.end(); destinationIterator++) {
       const DestinationInfo& destination = *destinationIterator;
       if(destination.address().is_v6() == SourceAddress.is_v6()) {
-         Destinations.insert(destination);
+         bool inserted;
+         insertDestination(destination, inserted);
       }
    }
-   DestinationIterator = Destinations.end();
+   DestinationPosition = DestinationRegistry::EndPosition;
+   ResumePosition      = DestinationRegistry::EndPosition;
 }
 
 
@@ -121,17 +138,16 @@ bool Traceroute::addDestination(const DestinationInfo& destination)
 {
    if(destination.address().is_v6() == SourceAddress.is_v6()) {
       std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
-      const std::set<DestinationInfo>::const_iterator destinationIterator =
-         Destinations.find(destination);
-
-      if(destinationIterator == Destinations.end()) {
-         if(DestinationIterator == Destinations.end()) {
+      bool inserted;
+      insertDestination(destination, inserted);
+      if(inserted) {
+         if(DestinationPosition == DestinationRegistry::EndPosition) {
             // Address will be the first destination in list -> abort interval timer
             IntervalTimer.expires_from_now(boost::posix_time::milliseconds(0));
             IntervalTimer.async_wait(std::bind(&Traceroute::handleIntervalEvent, this,
                                                std::placeholders::_1));
+            IntervalScheduled = true;
          }
-         Destinations.insert(destination);
          return true;
       }
 
@@ -141,6 +157,126 @@ bool Traceroute::addDestination(const DestinationInfo& destination)
 }
 
 
+// ###### Request out-of-schedule run for destination #######################
+// A destination, which is not in the list, is added as transient destination.
+// It is not traced in the regular iterations, and it is removed again at the
+// start of the next iteration after its triggered run.
+bool Traceroute::triggerDestination(const DestinationInfo& destination)
+{
+   if(destination.address().is_v6() == SourceAddress.is_v6()) {
+      std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+
+      // ====== Bound the number of queued runs =============================
+      if(TriggerQueue.size() >= MaxTriggerQueueLength) {
+         HPCT_LOG(debug) << getName() << ": Trigger queue is full, ignoring trigger for " << destination;
+         return false;
+      }
+      uint32_t destinationID = Destinations.find(destination);
+      if( (destinationID != DestinationRegistry::InvalidID) &&
+          (std::find(TriggerQueue.begin(), TriggerQueue.end(), destinationID) != TriggerQueue.end()) ) {
+         return false;   // Already queued -> nothing to do.
+      }
+
+      // ====== Bound the rate of triggered runs ============================
+      if(!takeTriggerToken()) {
+         HPCT_LOG(debug) << getName() << ": Trigger rate exceeded, ignoring trigger for " << destination;
+         return false;
+      }
+
+      // ====== Queue destination ===========================================
+      if(destinationID == DestinationRegistry::InvalidID) {
+         bool inserted;
+         destinationID            = insertDestination(destination, inserted);
+         Transient[destinationID] = true;
+         TransientCount++;
+      }
+      TriggerQueue.push_back(destinationID);
+      IOService.post(std::bind(&Traceroute::handleTrigger, this));
+      return true;
+   }
+   return false;
+}
+
+
+// ###### Take token for triggered run ######################################
+bool Traceroute::takeTriggerToken()
+{
+   std::lock_guard<std::mutex> lock(TriggerTokenMutex);
+
+   // ====== Refill bucket ==================================================
+   const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+   const double seconds = std::chrono::duration<double>(now - TriggerTokenTime).count();
+   TriggerTokens    = std::min((double)TriggerTokenBurst, TriggerTokens + seconds * TriggerTokenRate);
+   TriggerTokenTime = now;
+
+   // ====== Take token =====================================================
+   if(TriggerTokens >= 1.0) {
+      TriggerTokens -= 1.0;
+      return(true);
+   }
+   return(false);
+}
+
+
+// ###### Add destination to registry ######################################
+uint32_t Traceroute::insertDestination(const DestinationInfo& destination, bool& inserted)
+{
+   const uint32_t destinationID = Destinations.insert(destination, inserted);
+   if(inserted) {
+      initialiseDestinationState(destinationID);
+   }
+   return(destinationID);
+}
+
+
+// ###### Remove destination from registry ##################################
+// The ID may be reused for another destination. So, it must not remain in
+// the trigger and volatile queues.
+void Traceroute::removeDestinationAt(const size_t position)
+{
+   const uint32_t destinationID = Destinations.idAt(position);
+   if(Transient[destinationID]) {
+      TransientCount--;
+   }
+   Destinations.removeAt(position);
+   TriggerQueue.erase(std::remove(TriggerQueue.begin(), TriggerQueue.end(), destinationID),
+                      TriggerQueue.end());
+   VolatileQueue.erase(std::remove(VolatileQueue.begin(), VolatileQueue.end(), destinationID),
+                       VolatileQueue.end());
+}
+
+
+// ###### Remove transient destinations #####################################
+// Destinations still waiting for their triggered run are kept.
+void Traceroute::removeTransientDestinations()
+{
+   if(TransientCount > 0) {
+      for(size_t position = Destinations.size(); position > 0; position--) {
+         const uint32_t destinationID = Destinations.idAt(position - 1);
+         if( (Transient[destinationID]) &&
+             (std::find(TriggerQueue.begin(), TriggerQueue.end(), destinationID) == TriggerQueue.end()) ) {
+            HPCT_LOG(debug) << getName() << ": Removing transient " << Destinations.at(position - 1);
+            removeDestinationAt(position - 1);
+         }
+      }
+   }
+}
+
+
+// ###### Initialise per-destination state of new (or reused) ID ############
+void Traceroute::initialiseDestinationState(const uint32_t destinationID)
+{
+   if(destinationID >= TTLCache.size()) {
+      TTLCache.resize(Destinations.maxID());
+      CadenceCache.resize(Destinations.maxID());
+      Transient.resize(Destinations.maxID());
+   }
+   TTLCache[destinationID]     = 0;
+   CadenceCache[destinationID] = CadenceState();
+   Transient[destinationID]    = false;
+}
+
+
 // ###### Destructor ########################################################
 Traceroute::~Traceroute()
 {
@@ -236,37 +372,85 @@ bool Traceroute::prepareRun(const bool newRound)
       IterationNumber++;
 
       // ====== Rewind ======================================================
-      DestinationIterator = Destinations.begin();
+      removeTransientDestinations();
+      DestinationPosition = Destinations.first();
       for(unsigned int i = 0; i < Rounds; i++) {
          TargetChecksumArray[i] = ~0U;   // Use a new target checksum!
       }
+      SavedRuns = 0;
+      VolatileQueue.clear();
+   }
+   else if(TriggeredRun) {
+      // ====== Continue where the triggered run has interrupted ============
+      DestinationPosition = ResumePosition;
    }
    else {
       // ====== Get next destination address ================================
-      if(DestinationIterator != Destinations.end()) {
+      if(DestinationPosition != DestinationRegistry::EndPosition) {
          if(RemoveDestinationAfterRun == false) {
-            DestinationIterator++;
+            DestinationPosition = Destinations.next(DestinationPosition);
          }
          else {
-            std::set<DestinationInfo>::iterator toBeDeleted = DestinationIterator;
-            DestinationIterator++;
-            HPCT_LOG(debug) << getName() << ": Removing " << *toBeDeleted;
-            Destinations.erase(toBeDeleted);
+            // The last destination is moved into the position of the removed
+            // one. That is, the position is already the next one.
+            HPCT_LOG(debug) << getName() << ": Removing " << Destinations.at(DestinationPosition);
+            removeDestinationAt(DestinationPosition);
+            if(DestinationPosition >= Destinations.size()) {
+               DestinationPosition = DestinationRegistry::EndPosition;
+            }
+         }
+      }
+   }
+
+   TriggeredRun = false;
+
+   // ====== Skip transient destinations and destinations with stable path ==
+   while( (DestinationPosition != DestinationRegistry::EndPosition) &&
+          ( (Transient[Destinations.idAt(DestinationPosition)]) ||
+            (skipDestination(Destinations.idAt(DestinationPosition))) ) ) {
+      DestinationPosition = Destinations.next(DestinationPosition);
+   }
+
+   // ====== Triggered destinations take precedence =========================
+   while(!TriggerQueue.empty()) {
+      const uint32_t destinationID = TriggerQueue.front();
+      TriggerQueue.pop_front();
+      if(Destinations.isValid(destinationID)) {
+         ResumePosition      = DestinationPosition;
+         DestinationPosition = Destinations.positionOf(destinationID);
+         TriggeredRun        = true;
+         HPCT_LOG(debug) << getName() << ": Triggered run for " << Destinations.at(DestinationPosition);
+         break;
+      }
+   }
+
+   // ====== Use saved runs for volatile destinations =======================
+   if( (!TriggeredRun) && (DestinationPosition == DestinationRegistry::EndPosition) ) {
+      while( (SavedRuns > 0) && (!VolatileQueue.empty()) ) {
+         const uint32_t destinationID = VolatileQueue.front();
+         VolatileQueue.pop_front();
+         if(Destinations.isValid(destinationID)) {
+            SavedRuns--;
+            ResumePosition      = DestinationPosition;
+            DestinationPosition = Destinations.positionOf(destinationID);
+            TriggeredRun        = true;
+            HPCT_LOG(debug) << getName() << ": Additional run for volatile " << Destinations.at(DestinationPosition);
+            break;
          }
       }
    }
 
    // ====== Clear results ==================================================
-   ResultsMap.clear();
+   Probes.clear();
    MinTTL              = 1;
-   MaxTTL              = (DestinationIterator != Destinations.end()) ?
-                            getInitialMaxTTL(*DestinationIterator) : InitialMaxTTL;
+   MaxTTL              = (DestinationPosition != DestinationRegistry::EndPosition) ?
+                            getInitialMaxTTL(Destinations.idAt(DestinationPosition)) : InitialMaxTTL;
    LastHop             = 0xffffffff;
    OutstandingRequests = 0;
    RunStartTimeStamp   = std::chrono::steady_clock::now();
 
    // Return whether end of the list is reached. Then, a rewind is necessary.
-   return(DestinationIterator == Destinations.end());
+   return(DestinationPosition == DestinationRegistry::EndPosition);
 }
 
 
@@ -276,8 +460,8 @@ void Traceroute::sendRequests()
    std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
 
    // ====== Send requests, if there are destination addresses ==============
-   if(DestinationIterator != Destinations.end()) {
-      const DestinationInfo& destination = *DestinationIterator;
+   if(DestinationPosition != DestinationRegistry::EndPosition) {
+      const DestinationInfo& destination = Destinations.at(DestinationPosition);
       HPCT_LOG(debug) << getName() << ": Traceroute from " << SourceAddress
                       << " to " << destination << " ...";
 
@@ -285,7 +469,8 @@ void Traceroute::sendRequests()
       assert(MinTTL > 0);
       for(unsigned int round = 0; round < Rounds; round++) {
          for(int ttl = (int)MaxTTL; ttl >= (int)MinTTL; ttl--) {
-            sendICMPRequest(destination, (unsigned int)ttl, round,
+            sendICMPRequest(destination, Destinations.idAt(DestinationPosition),
+                            (unsigned int)ttl, round,
                             TargetChecksumArray[round]);
          }
       }
@@ -325,7 +510,7 @@ void Traceroute::scheduleIntervalEvent()
 
       // ====== Schedule event ==============================================
       long long millisecondsToWait;
-      if(Destinations.begin() == Destinations.end()) {
+      if(Destinations.empty()) {
           // Nothing to do -> wait 1 day
           millisecondsToWait = 24*3600*1000;
       }
@@ -340,6 +525,7 @@ void Traceroute::scheduleIntervalEvent()
       IntervalTimer.expires_from_now(boost::posix_time::milliseconds(millisecondsToWait));
       IntervalTimer.async_wait(std::bind(&Traceroute::handleIntervalEvent, this,
                                          std::placeholders::_1));
+      IntervalScheduled = true;
       HPCT_LOG(debug) << getName() << ": Waiting " << millisecondsToWait / 1000.0
                       << "s before iteration " << (IterationNumber + 1) << " ...";
 
@@ -387,18 +573,82 @@ void Traceroute::noMoreOutstandingRequests()
 
 
 // ###### Get value for initial MaxTTL ######################################
-unsigned int Traceroute::getInitialMaxTTL(const DestinationInfo& destination) const
+unsigned int Traceroute::getInitialMaxTTL(const uint32_t destinationID) const
 {
-   const std::map<DestinationInfo, unsigned int>::const_iterator found = TTLCache.find(destination);
-   if(found != TTLCache.end()) {
-      return(std::min(found->second, FinalMaxTTL));
+   if(TTLCache[destinationID] > 0) {
+      return(std::min(TTLCache[destinationID], FinalMaxTTL));
    }
    return(InitialMaxTTL);
 }
 
 
+// ###### Check whether destination is skipped in this iteration ############
+bool Traceroute::skipDestination(const uint32_t destinationID)
+{
+   CadenceState& state = CadenceCache[destinationID];
+   if(state.SkipIterations > 0) {
+      state.SkipIterations--;
+      SavedRuns++;
+      return(true);
+   }
+   return(false);
+}
+
+
+// ###### Update cadence of destination after a run #########################
+// An out-of-schedule run (not scheduled) may detect a change, but it does not
+// let a stable destination back off further. Only a hop becoming unreachable
+// is a change; a permanently unreachable destination backs off like a stable
+// one. (A different unreachable hop changes the path signature.)
+void Traceroute::updateCadence(const uint32_t destinationID,
+                               const uint64_t pathSignature,
+                               const bool     unreachable,
+                               const bool     scheduled)
+{
+   if( (MaxInterval <= Interval) || (RemoveDestinationAfterRun) ) {
+      return;   // Adaptive cadence is turned off
+   }
+   const unsigned int maxBackoff = (unsigned int)std::min(MaxInterval / Interval, 65536ULL);
+
+   CadenceState& state = CadenceCache[destinationID];
+   if(state.Backoff == 0) {
+      // ====== First run: start with full cadence ==========================
+      state.PathSignature  = pathSignature;
+      state.Backoff        = 1;
+      state.SkipIterations = 0;
+      state.Unreachable    = unreachable;
+   }
+   else {
+      const bool becameUnreachable = (unreachable) && (!state.Unreachable);
+      state.Unreachable = unreachable;
+      if( (becameUnreachable) || (pathSignature != state.PathSignature) ) {
+         // ====== Path has changed: back to full cadence ===================
+         if(state.Backoff > 1) {
+            HPCT_LOG(debug) << getName() << ": Path to " << Destinations.at(Destinations.positionOf(destinationID))
+                            << " has changed, tracing in every iteration again";
+         }
+
+         // ====== Volatile path: trace again with saved runs ===============
+         if( (pathSignature != state.PathSignature) &&
+             (std::find(VolatileQueue.begin(), VolatileQueue.end(), destinationID) == VolatileQueue.end()) ) {
+            VolatileQueue.push_back(destinationID);
+         }
+         state.PathSignature  = pathSignature;
+         state.Backoff        = 1;
+         state.SkipIterations = 0;
+      }
+      else if(scheduled) {
+         // ====== Path is stable: back off =================================
+         state.Backoff        = std::min(2 * state.Backoff, maxBackoff);
+         state.SkipIterations = state.Backoff - 1;
+      }
+   }
+}
+
+
 // ###### Send one ICMP request to given destination ########################
 void Traceroute::sendICMPRequest(const DestinationInfo& destination,
+                                 const uint32_t         destinationID,
                                  const unsigned int     ttl,
                                  const unsigned int     round,
                                  uint32_t&              targetChecksum)
@@ -489,10 +739,9 @@ void Traceroute::sendICMPRequest(const DestinationInfo& destination,
       OutstandingRequests++;
 
       assert((targetChecksum & ~0xffff) == 0);
-      ResultEntry resultEntry(round, SeqNumber, ttl, (uint16_t)targetChecksum, sendTime,
-                              destination, Unknown);
-      std::pair<std::map<unsigned short, ResultEntry>::iterator, bool> result = ResultsMap.insert(std::pair<unsigned short, ResultEntry>(SeqNumber,resultEntry));
-      assert(result.second == true);
+      const bool added = Probes.add(SeqNumber, round, ttl, (uint16_t)targetChecksum, sendTime,
+                                    destinationID);
+      assert(added == true);
    }
 }
 
@@ -519,7 +768,7 @@ bool Traceroute::notReachedWithCurrentTTL()
    if(MaxTTL < FinalMaxTTL) {
       MinTTL = MaxTTL + 1;
       MaxTTL = std::min(MaxTTL + IncrementMaxTTL, FinalMaxTTL);
-      HPCT_LOG(debug) << getName() << ": Cannot reach " << *DestinationIterator
+      HPCT_LOG(debug) << getName() << ": Cannot reach " << Destinations.at(DestinationPosition)
                       << " with TTL " << MinTTL - 1 << ", now trying TTLs "
                       << MinTTL << " to " << MaxTTL << " ...";
       return(true);
@@ -538,16 +787,27 @@ int Traceroute::compareTracerouteResults(const ResultEntry* a, const ResultEntry
 // ###### Process results ###################################################
 void Traceroute::processResults()
 {
-   uint64_t timeStamp = 0;
+   uint64_t timeStamp     = 0;
+   uint64_t pathSignature = 0;
+   bool     unreachable   = false;
 
    // ====== Sort results ===================================================
+   std::vector<ResultEntry> resultsArray;
+   resultsArray.reserve(Probes.size());
+   for(unsigned int i = 0; i < Probes.window(); i++) {
+      if(Probes.isUsed(i)) {
+         resultsArray.push_back(Probes.entry(i, Destinations));
+      }
+   }
    std::vector<ResultEntry*> resultsVector;
-   for(std::map<unsigned short, ResultEntry>::iterator iterator = ResultsMap.begin(); iterator != ResultsMap.end(); iterator++) {
-      resultsVector.push_back(&iterator->second);
+   for(std::vector<ResultEntry>::iterator iterator = resultsArray.begin(); iterator != resultsArray.end(); iterator++) {
+      resultsVector.push_back(&(*iterator));
    }
    std::sort(resultsVector.begin(), resultsVector.end(), &compareTracerouteResults);
 
    // ====== Handle the results of each round ===============================
+   // The records of all rounds are written as one batch.
+   std::vector<TracerouteRecord> records;
    for(unsigned int round = 0; round < Rounds; round++) {
 
       // ====== Count hops ==================================================
@@ -555,7 +815,7 @@ void Traceroute::processResults()
       std::size_t currentHop         = 0;
       bool        completeTraceroute = true;   // all hops have responded
       bool        destinationReached = false;  // destination has responded
-      std::string pathString         = SourceAddress.to_string();
+      std::string pathString         = AddressTexts.text(SourceAddress);
       for(std::vector<ResultEntry*>::iterator iterator = resultsVector.begin(); iterator != resultsVector.end(); iterator++) {
          ResultEntry* resultEntry = *iterator;
          if(resultEntry->round() == round) {
@@ -565,14 +825,17 @@ void Traceroute::processResults()
 
             // ====== We have reached the destination =======================
             if(resultEntry->status() == Success) {
-               pathString += "-" + resultEntry->destinationAddress().to_string();
+               pathString += '-';
+               pathString += AddressTexts.text(resultEntry->destinationAddress());
                destinationReached = true;
                break;   // done!
             }
 
             // ====== Unreachable (as reported by router) ===================
             else if(statusIsUnreachable(resultEntry->status())) {
-               pathString += "-" + resultEntry->destinationAddress().to_string();
+               pathString += '-';
+               pathString += AddressTexts.text(resultEntry->destinationAddress());
+               unreachable = true;
                break;   // we can stop here!
             }
 
@@ -586,7 +849,8 @@ void Traceroute::processResults()
 
             // ====== Some other response (usually TTL exceeded) ============
             else {
-               pathString += "-" + resultEntry->destinationAddress().to_string();
+               pathString += '-';
+               pathString += AddressTexts.text(resultEntry->destinationAddress());
             }
          }
       }
@@ -599,6 +863,7 @@ void Traceroute::processResults()
       uint32_t digest[5];
       sha1Hash.get_digest(digest);
       const uint64_t pathHash    = ((uint64_t)digest[0] << 32) | (uint64_t)digest[1];
+      pathSignature += pathHash;
       unsigned int   statusFlags = 0x0000;
       if(!completeTraceroute) {
          statusFlags |= Flag_StarredRoute;
@@ -610,8 +875,7 @@ void Traceroute::processResults()
       // ====== Print traceroute entries =======================================
       HPCT_LOG(trace) << getName() << ": Round " << round << ":";
 
-      bool     writeHeader   = true;
-      uint16_t checksumCheck = 0;
+      TracerouteRecord record;
       for(std::vector<ResultEntry*>::iterator iterator = resultsVector.begin(); iterator != resultsVector.end(); iterator++) {
          ResultEntry* resultEntry = *iterator;
          if(resultEntry->round() == round) {
@@ -631,31 +895,25 @@ void Traceroute::processResults()
                   timeStamp = usSinceEpoch(resultEntry->sendTime());
                }
 
-               if(writeHeader) {
-                  ResultsOutput->insert(
-                     str(boost::format("#T %s %s %x %d %x %d %x %x %x")
-                        % SourceAddress.to_string()
-                        % (*DestinationIterator).address().to_string()
-                        % timeStamp
-                        % round
-                        % resultEntry->checksum()
-                        % totalHops
-                        % statusFlags
-                        % (int64_t)pathHash
-                        % (unsigned int)(*DestinationIterator).trafficClass()
-                  ));
-                  writeHeader = false;
-                  checksumCheck = resultEntry->checksum();
+               if(record.Hops.empty()) {
+                  record.Source       = SourceAddress;
+                  record.Destination  = Destinations.at(DestinationPosition).address();
+                  record.TimeStamp    = timeStamp;
+                  record.Round        = round;
+                  record.Checksum     = resultEntry->checksum();
+                  record.TotalHops    = totalHops;
+                  record.StatusFlags  = statusFlags;
+                  record.PathHash     = pathHash;
+                  record.TrafficClass = Destinations.at(DestinationPosition).trafficClass();
                }
 
-               ResultsOutput->insert(
-                  str(boost::format("\t %d %x %d %s")
-                     % resultEntry->hop()
-                     % (unsigned int)resultEntry->status()
-                     % std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count()
-                     % resultEntry->destinationAddress().to_string()
-               ));
-               assert(resultEntry->checksum() == checksumCheck);
+               TracerouteHopRecord hop;
+               hop.Hop     = resultEntry->hop();
+               hop.Status  = resultEntry->status();
+               hop.RTT     = std::chrono::duration_cast<std::chrono::microseconds>(resultEntry->receiveTime() - resultEntry->sendTime()).count();
+               hop.Address = resultEntry->destinationAddress();
+               record.Hops.push_back(hop);
+               assert(resultEntry->checksum() == record.Checksum);
             }
 
             if( (resultEntry->status() == Success) ||
@@ -664,6 +922,18 @@ void Traceroute::processResults()
             }
          }
       }
+      if(!record.Hops.empty()) {
+         records.push_back(std::move(record));
+      }
+   }
+   if(!records.empty()) {
+      ResultsOutput->insert(records);
+   }
+
+   // ====== Adapt cadence ==================================================
+   if(DestinationPosition != DestinationRegistry::EndPosition) {
+      updateCadence(Destinations.idAt(DestinationPosition), pathSignature, unreachable,
+                    !TriggeredRun);
    }
 }
 
@@ -675,8 +945,8 @@ void Traceroute::handleTimeoutEvent(const boost::system::error_code& errorCode)
       std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
 
       // ====== Has destination been reached with current TTL? ==============
-      if(DestinationIterator != Destinations.end()) {
-         TTLCache[*DestinationIterator] = LastHop;
+      if(DestinationPosition != DestinationRegistry::EndPosition) {
+         TTLCache[Destinations.idAt(DestinationPosition)] = LastHop;
          if(LastHop == 0xffffffff) {
             if(notReachedWithCurrentTTL()) {
                // Try another round ...
@@ -693,8 +963,16 @@ void Traceroute::handleTimeoutEvent(const boost::system::error_code& errorCode)
       if(prepareRun() == false) {
          sendRequests();
       }
-      else {
+      else if(IterationDeferred) {
+         // The interval timer has expired during the triggered run
+         IterationDeferred = false;
+         prepareRun(true);
+         sendRequests();
+      }
+      else if(!IntervalScheduled) {
          // Done with this round -> schedule next round!
+         // NOTE: A triggered run between two iterations leaves the interval
+         //       timer running. Then, there is nothing to schedule here.
          scheduleIntervalEvent();
       }
    }
@@ -707,6 +985,13 @@ void Traceroute::handleIntervalEvent(const boost::system::error_code& errorCode)
    if(StopRequested == false) {
       // ====== Prepare new run =============================================
       if(errorCode != boost::asio::error::operation_aborted) {
+         std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+         IntervalScheduled = false;
+         if(TriggeredRun) {
+            // Start the iteration after the triggered run has finished
+            IterationDeferred = true;
+            return;
+         }
          HPCT_LOG(debug) << getName() << ": Starting iteration " << (IterationNumber + 1) << " ...";
          prepareRun(true);
          sendRequests();
@@ -715,6 +1000,25 @@ void Traceroute::handleIntervalEvent(const boost::system::error_code& errorCode)
 }
 
 
+// ###### Handle triggered destination ######################################
+void Traceroute::handleTrigger()
+{
+   if(StopRequested == false) {
+      std::lock_guard<std::recursive_mutex> lock(DestinationMutex);
+
+      // ====== Waiting for next iteration -> start triggered run now =======
+      // Otherwise, prepareRun() picks up the queued destination after the
+      // current run.
+      if( (!TriggeredRun) && (DestinationPosition == DestinationRegistry::EndPosition) &&
+          (!TriggerQueue.empty()) ) {
+         if(prepareRun() == false) {
+            sendRequests();
+         }
+      }
+   }
+}
+
+
 // ###### Handle incoming ICMP message ######################################
 void Traceroute::handleMessage(const boost::system::error_code& errorCode,
                                std::size_t                      length)
@@ -804,18 +1108,13 @@ void Traceroute::recordResult(const std::chrono::system_clock::time_point& recei
                               const unsigned short                         seqNumber)
 {
    // ====== Find corresponding request =====================================
-   std::map<unsigned short, ResultEntry>::iterator found = ResultsMap.find(seqNumber);
-   if(found == ResultsMap.end()) {
+   unsigned int index;
+   if(Probes.find(seqNumber, index) == false) {
       return;
    }
-   ResultEntry& resultEntry = found->second;
 
    // ====== Get status =====================================================
-   if(resultEntry.status() == Unknown) {
-      resultEntry.setReceiveTime(receiveTime);
-      // Just set address, keep traffic class and identifier settings:
-      resultEntry.setDestinationAddress(ReplyEndpoint.address());
-
+   if(Probes.status(index) == Unknown) {
       HopStatus status = Unknown;
       if( (icmpHeader.type() == ICMPHeader::IPv6TimeExceeded) ||
           (icmpHeader.type() == ICMPHeader::IPv4TimeExceeded) ) {
@@ -870,9 +1169,9 @@ void Traceroute::recordResult(const std::chrono::system_clock::time_point& recei
       else if( (icmpHeader.type() == ICMPHeader::IPv6EchoReply) ||
                (icmpHeader.type() == ICMPHeader::IPv4EchoReply) ) {
          status  = Success;
-         LastHop = std::min(LastHop, resultEntry.hop());
+         LastHop = std::min(LastHop, Probes.hop(index));
       }
-      resultEntry.setStatus(status);
+      Probes.setResult(index, receiveTime, ReplyEndpoint.address(), status);
       if(OutstandingRequests > 0) {
          OutstandingRequests--;
       }
@@ -33,21 +33,40 @@
 #define TRACEROUTE_H
 
 #include "service.h"
+#include "destinationregistry.h"
+#include "probetable.h"
 #include "resultentry.h"
 #include "resultswriter.h"
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 
 #include <boost/asio.hpp>
 
 
 class ICMPHeader;
 
+// Adaptive cadence: a destination with a stable path is only traced in every
+// Backoff-th iteration. Backoff doubles with each unchanged run, up to
+// MaxInterval / Interval, and falls back to 1 on any change. Backoff 0 means
+// that there has not been any run yet. Out-of-schedule runs do not back off.
+// The runs saved by skipping stable destinations are used at the end of the
+// iteration for additional runs to volatile destinations, i.e. destinations
+// whose path has changed.
+struct CadenceState
+{
+   uint64_t     PathSignature;    // Sum of the path hashes of all rounds
+   unsigned int Backoff;          // Trace in every Backoff-th iteration
+   unsigned int SkipIterations;   // Iterations to skip before next trace
+   bool         Unreachable;      // Last run had an unreachable hop
+};
+
 class Traceroute : public Service
 {
    public:
@@ -62,11 +81,13 @@ class Traceroute : public Service
               const unsigned int               initialMaxTTL   = 5,
               const unsigned int               finalMaxTTL     = 35,
               const unsigned int               incrementMaxTTL = 2,
-              const unsigned int               priority        = 20);
+              const unsigned int               priority        = 20,
+              const unsigned long long         maxInterval     = 0);
    virtual ~Traceroute();
 
    virtual const boost::asio::ip::address& getSource();
    virtual bool addDestination(const DestinationInfo& destination);
+   bool triggerDestination(const DestinationInfo& destination);
 
    virtual const std::string& getName() const;
    virtual bool start();
@@ -90,6 +111,7 @@ class Traceroute : public Service
    virtual void sendRequests();
    virtual void handleTimeoutEvent(const boost::system::error_code& errorCode);
    virtual void handleIntervalEvent(const boost::system::error_code& errorCode);
+   virtual void handleTrigger();
    virtual void handleMessage(const boost::system::error_code& errorCode,
                               std::size_t                      length);
 
@@ -99,13 +121,24 @@ class Traceroute : public Service
 
    void run();
    void sendICMPRequest(const DestinationInfo& destination,
+                        const uint32_t                 destinationID,
                         const unsigned int             ttl,
                         const unsigned int             round,
                         uint32_t&                      targetChecksum);
    void recordResult(const std::chrono::system_clock::time_point& receiveTime,
                      const ICMPHeader&                            icmpHeader,
                      const unsigned short                         seqNumber);
-   unsigned int getInitialMaxTTL(const DestinationInfo&   destination) const;
+   uint32_t insertDestination(const DestinationInfo& destination, bool& inserted);
+   void removeDestinationAt(const size_t position);
+   void removeTransientDestinations();
+   static bool takeTriggerToken();
+   virtual void initialiseDestinationState(const uint32_t destinationID);
+   unsigned int getInitialMaxTTL(const uint32_t destinationID) const;
+   bool skipDestination(const uint32_t destinationID);
+   void updateCadence(const uint32_t destinationID,
+                      const uint64_t pathSignature,
+                      const bool     unreachable,
+                      const bool     scheduled);
 
    static unsigned long long makePacketTimeStamp(const std::chrono::system_clock::time_point& time);
 
@@ -119,11 +152,19 @@ class Traceroute : public Service
    const unsigned int                      InitialMaxTTL;
    const unsigned int                      FinalMaxTTL;
    const unsigned int                      IncrementMaxTTL;
+   const unsigned long long                MaxInterval;
    boost::asio::io_service                 IOService;
    boost::asio::ip::address                SourceAddress;
    std::recursive_mutex                    DestinationMutex;
-   std::set<DestinationInfo>               Destinations;
-   std::set<DestinationInfo>::iterator     DestinationIterator;
+   DestinationRegistry                     Destinations;
+   size_t                                  DestinationPosition;
+   std::deque<uint32_t>                    TriggerQueue;      // IDs for out-of-schedule runs
+   std::deque<uint32_t>                    VolatileQueue;     // IDs for runs with saved budget
+   unsigned int                            SavedRuns;         // Skipped runs in this iteration
+   size_t                                  ResumePosition;    // Regular run after triggered one
+   bool                                    TriggeredRun;      // Out-of-schedule run
+   bool                                    IterationDeferred;
+   bool                                    IntervalScheduled;
    boost::asio::ip::icmp::socket           ICMPSocket;
    boost::asio::deadline_timer             TimeoutTimer;
    boost::asio::deadline_timer             IntervalTimer;
@@ -137,8 +178,12 @@ class Traceroute : public Service
    unsigned int                            MagicNumber;
    unsigned int                            OutstandingRequests;
    unsigned int                            LastHop;
-   std::map<unsigned short, ResultEntry>   ResultsMap;
-   std::map<DestinationInfo, unsigned int> TTLCache;
+   ProbeTable                              Probes;
+   std::vector<unsigned int>               TTLCache;          // By destination ID, 0 if unknown
+   std::vector<CadenceState>               CadenceCache;      // By destination ID
+   std::vector<bool>                       Transient;         // By destination ID (only triggered)
+   size_t                                  TransientCount;
+   AddressTextCache                        AddressTexts;      // For the path strings
    bool                                    ExpectingReply;
    char                                    MessageBuffer[65536 + 40];
    unsigned int                            MinTTL;
@@ -147,6 +192,17 @@ class Traceroute : public Service
    uint32_t*                               TargetChecksumArray;
    unsigned int                            Priority;
 
+   static const size_t                     MaxTriggerQueueLength = 64;
+
+   // Token bucket for triggered runs, shared by all Traceroute services. So,
+   // a routing event affecting many destinations cannot flood the network
+   // with triggered runs:
+   static std::mutex                       TriggerTokenMutex;
+   static double                           TriggerTokens;
+   static std::chrono::steady_clock::time_point TriggerTokenTime;
+   static const unsigned int               TriggerTokenRate      = 1;    // Tokens per second
+   static const unsigned int               TriggerTokenBurst     = 10;   // Bucket size
+
    private:
    static int compareTracerouteResults(const ResultEntry* a, const ResultEntry* b);
 };
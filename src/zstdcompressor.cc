@@ -0,0 +1,111 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#include "zstdcompressor.h"
+
+#ifdef HAVE_ZSTD
+
+#include "logger.h"
+
+#include <fstream>
+#include <iterator>
+
+
+int                         ZstdCompressor::Level   = 3;
+unsigned int                ZstdCompressor::Workers = 0;
+std::shared_ptr<ZSTD_CDict> ZstdCompressor::Dictionary;
+
+
+// ###### Constructor #######################################################
+ZstdCompressor::ZstdCompressor()
+   : Context(ZSTD_createCCtx(), ZSTD_freeCCtx),
+     OutputBuffer(new std::vector<char>(ZSTD_CStreamOutSize()))
+{
+   if(!Context) {
+      throw std::ios_base::failure("Unable to create Zstandard context");
+   }
+   if(Dictionary) {
+      // NOTE: The compression level is part of the digested dictionary.
+      ZSTD_CCtx_refCDict(Context.get(), Dictionary.get());
+   }
+   else {
+      ZSTD_CCtx_setParameter(Context.get(), ZSTD_c_compressionLevel, Level);
+   }
+   if(Workers > 0) {
+      // This fails, if libzstd has been built without multithreading support.
+      // Compression is then just done in the calling thread.
+      ZSTD_CCtx_setParameter(Context.get(), ZSTD_c_nbWorkers, (int)Workers);
+   }
+}
+
+
+// ###### Set parameters for all instances ##################################
+bool ZstdCompressor::configure(const int          level,
+                               const unsigned int workers,
+                               const std::string& dictionaryFileName)
+{
+   // ====== Check parameters ===============================================
+   Level   = std::min(std::max(ZSTD_minCLevel(), level), ZSTD_maxCLevel());
+   Workers = workers;
+   if(Workers > 0) {
+      const ZSTD_bounds bounds = ZSTD_cParam_getBounds(ZSTD_c_nbWorkers);
+      if( (ZSTD_isError(bounds.error)) || (bounds.upperBound < 1) ) {
+         HPCT_LOG(warning) << "Zstandard library has no multithreading support, using 0 workers";
+         Workers = 0;
+      }
+      else {
+         Workers = std::min(Workers, (unsigned int)bounds.upperBound);
+      }
+   }
+
+   // ====== Load dictionary ================================================
+   Dictionary.reset();
+   if(!dictionaryFileName.empty()) {
+      std::ifstream dictionaryFile(dictionaryFileName, std::ios_base::in | std::ios_base::binary);
+      const std::vector<char> dictionary((std::istreambuf_iterator<char>(dictionaryFile)),
+                                         std::istreambuf_iterator<char>());
+      if( (!dictionaryFile.good() && !dictionaryFile.eof()) || (dictionary.empty()) ) {
+         HPCT_LOG(error) << "Unable to read Zstandard dictionary " << dictionaryFileName;
+         return(false);
+      }
+      Dictionary.reset(ZSTD_createCDict(dictionary.data(), dictionary.size(), Level),
+                       ZSTD_freeCDict);
+      if(!Dictionary) {
+         HPCT_LOG(error) << "Unable to digest Zstandard dictionary " << dictionaryFileName;
+         return(false);
+      }
+      HPCT_LOG(info) << "Using Zstandard dictionary " << dictionaryFileName
+                     << " (ID " << ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size()) << ")";
+   }
+   return(true);
+}
+
+#endif
@@ -0,0 +1,107 @@
+// =================================================================
+//          #     #                 #     #
+//          ##    #   ####   #####  ##    #  ######   #####
+//          # #   #  #    #  #    # # #   #  #          #
+//          #  #  #  #    #  #    # #  #  #  #####      #
+//          #   # #  #    #  #####  #   # #  #          #
+//          #    ##  #    #  #   #  #    ##  #          #
+//          #     #   ####   #    # #     #  ######     #
+//
+//       ---   The NorNet Testbed for Multi-Homed Systems  ---
+//                       https://www.nntb.no
+// =================================================================
+//
+// High-Performance Connectivity Tracer (HiPerConTracer)
+// Copyright (C) 2015-2020 by Thomas Dreibholz
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact: dreibh@simula.no
+
+#ifndef ZSTDCOMPRESSOR_H
+#define ZSTDCOMPRESSOR_H
+
+#ifdef HAVE_ZSTD
+
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/operations.hpp>
+
+#include <zstd.h>
+
+
+// Boost Iostreams output filter for Zstandard compression. Compression level,
+// number of worker threads and the optional dictionary are set for all
+// instances by configure(). The dictionary is digested only once, and then
+// shared by all instances.
+class ZstdCompressor
+{
+   public:
+   typedef char char_type;
+   struct category : boost::iostreams::multichar_output_filter_tag,
+                     boost::iostreams::closable_tag { };
+
+   ZstdCompressor();
+
+   static bool configure(const int          level,
+                         const unsigned int workers,
+                         const std::string& dictionaryFileName);
+
+   // ====== Compress data ==================================================
+   template<typename Sink> std::streamsize write(Sink&           sink,
+                                                 const char*     data,
+                                                 std::streamsize length) {
+      ZSTD_inBuffer input = { data, (size_t)length, 0 };
+      while(input.pos < input.size) {
+         compress(sink, input, ZSTD_e_continue);
+      }
+      return(length);
+   }
+
+   // ====== Finish frame ===================================================
+   template<typename Sink> void close(Sink& sink) {
+      ZSTD_inBuffer input = { nullptr, 0, 0 };
+      while(compress(sink, input, ZSTD_e_end) > 0) { }
+   }
+
+   private:
+   template<typename Sink> size_t compress(Sink&             sink,
+                                           ZSTD_inBuffer&    input,
+                                           ZSTD_EndDirective mode) {
+      ZSTD_outBuffer output    = { OutputBuffer->data(), OutputBuffer->size(), 0 };
+      const size_t   remaining = ZSTD_compressStream2(Context.get(), &output, &input, mode);
+      if(ZSTD_isError(remaining)) {
+         throw std::ios_base::failure(ZSTD_getErrorName(remaining));
+      }
+      if(output.pos > 0) {
+         boost::iostreams::write(sink, OutputBuffer->data(), output.pos);
+      }
+      return(remaining);
+   }
+
+   std::shared_ptr<ZSTD_CCtx>         Context;
+   std::shared_ptr<std::vector<char>> OutputBuffer;
+
+   static int                         Level;
+   static unsigned int                Workers;
+   static std::shared_ptr<ZSTD_CDict> Dictionary;
+};
+
+#endif
+
+#endif